@@ -0,0 +1,161 @@
+#ifndef RSDLAB_BAUMER_USE_SIMULATOR
+#define RSDLAB_BAUMER_USE_SIMULATOR
+#endif
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "Baumer.h"
+
+/*
+* 擾̃x`}[N
+* ͋[JSẴsNZtH[}bg,𑜓x̉摜ǂݍ,read()̋ԂƂ̏vԂJSONŏo͂
+* g: bench [vt[] [o̓t@C(ȗ͕Wo)]
+*/
+
+/**
+* read()̋ԂƂ̃qXgO
+*/
+struct stage_histograms {
+	baumer::latency_histogram wait;
+	baumer::latency_histogram dispatch;
+	baumer::latency_histogram convert;
+	baumer::latency_histogram shift;
+	baumer::latency_histogram requeue;
+	baumer::latency_histogram total;
+};
+
+/**
+* qXgȌo
+* @param[in] fp o͐
+* @param[in] name Ԗ
+* @param[in] h qXgO
+* @param[in] last Ō̗vf
+*/
+static void writeHistogram(FILE* fp, const char* name, const baumer::latency_histogram& h, bool last) {
+	fprintf(fp, "\t\t\t\t\"%s\": {\"count\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu}%s\n",
+		name, (unsigned long long)h.count(), h.mean(), (unsigned long long)h.percentile(0.5), (unsigned long long)h.percentile(0.99),
+		(unsigned long long)h.percentile(0.999), (unsigned long long)h.maximum(), last ? "" : ",");
+}
+
+/**
+* 1̌v
+* @param[in] fp o͐
+* @param[in] format sNZtH[}bg
+* @param[in] size 𑜓x
+* @param[in] zeroCopy [Rs[ǂݍ݂ɂ邩
+* @param[in] frames vt[
+* @param[in] first ŏ̌ʂ
+* @return bool vł
+*/
+static bool run(FILE* fp, const char* format, cv::Size size, bool zeroCopy, int frames, bool first) {
+	baumer::simulator_config config;
+	config.width = size.width;
+	config.height = size.height;
+	config.fps = 0;	//擾̑xŐ
+	config.pixelFormats.push_back(format);
+	baumer::simulator::setCameras(1, config);
+
+	baumer::VideoCapture cap;
+	if (cap.size() == 0 || !cap.start()) {
+		std::cerr << "error: " << format << " " << size << std::endl;
+		return false;
+	}
+
+	cap[0].setProfiling(true);
+	cap[0].setZeroCopy(zeroCopy);
+
+	cv::Mat frame;
+	for (int i = 0; i < 10; i++) {
+		cap[0].read(frame);
+	}
+
+	stage_histograms h;
+	int failures = 0;
+	size_t payload = baumer::simulator::rowBytes(size.width, baumer::toPixelFormat(format)) * size.height;
+	uint64_t begin = baumer::steadyNow();
+	for (int i = 0; i < frames; i++) {
+		uint64_t t0 = baumer::steadyNow();
+		if (!cap[0].read(frame)) {
+			failures++;
+			continue;
+		}
+		uint64_t t1 = baumer::steadyNow();
+
+		baumer::read_timing timing = cap[0].getReadTiming();
+		h.wait.record(timing.wait);
+		h.dispatch.record(timing.dispatch);
+		h.convert.record(timing.convert);
+		h.shift.record(timing.shift);
+		h.requeue.record(timing.requeue);
+		h.total.record(t1 - t0);
+	}
+	double seconds = (baumer::steadyNow() - begin) * 1e-9;
+	frame.release();
+	cap.stop();
+
+	double fps = h.total.count() / seconds;
+	fprintf(fp, "%s\t\t{\n", first ? "" : ",\n");
+	fprintf(fp, "\t\t\t\"format\": \"%s\", \"width\": %d, \"height\": %d, \"zeroCopy\": %s,\n", format, size.width, size.height, zeroCopy ? "true" : "false");
+	fprintf(fp, "\t\t\t\"frames\": %llu, \"failures\": %d, \"fps\": %.1f, \"GBps\": %.3f,\n", (unsigned long long)h.total.count(), failures, fps, fps * payload * 1e-9);
+	fprintf(fp, "\t\t\t\"latency\": {\n");
+	writeHistogram(fp, "wait", h.wait, false);
+	writeHistogram(fp, "dispatch", h.dispatch, false);
+	writeHistogram(fp, "convert", h.convert, false);
+	writeHistogram(fp, "shift", h.shift, false);
+	writeHistogram(fp, "requeue", h.requeue, false);
+	writeHistogram(fp, "total", h.total, true);
+	fprintf(fp, "\t\t\t}\n\t\t}");
+	return true;
+}
+
+int main(int argc, char** argv) {
+	int frames = argc > 1 ? atoi(argv[1]) : 300;
+	FILE* fp = argc > 2 ? fopen(argv[2], "w") : stdout;
+	if (fp == NULL) {
+		std::cerr << "error: cannot open " << argv[2] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+#if defined(RSDLAB_BAUMER_AVX2)
+	const char* simd = "AVX2";
+#elif defined(RSDLAB_BAUMER_SSE2)
+	const char* simd = "SSE2";
+#elif defined(RSDLAB_BAUMER_NEON)
+	const char* simd = "NEON";
+#else
+	const char* simd = "none";
+#endif
+
+	const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(1920, 1200), cv::Size(4096, 3000) };
+
+	fprintf(fp, "{\n\t\"unit\": \"nsec\",\n\t\"simd\": \"%s\",\n\t\"threads\": %d,\n\t\"results\": [\n", simd, cv::getNumThreads());
+	bool first = true;
+	bool ok = true;
+	for (size_t i = 0; i < sizeof(baumer::pixelFormatNames) / sizeof(baumer::pixelFormatNames[0]); i++) {
+		//ʖ(BGR8PackedȂ)͓ɂȂ邽1xv
+		bool duplicate = false;
+		for (size_t j = 0; j < i; j++) {
+			duplicate |= baumer::pixelFormatNames[j].format == baumer::pixelFormatNames[i].format;
+		}
+		if (duplicate)continue;
+
+		const char* format = baumer::pixelFormatNames[i].name;
+		bool direct = baumer::getDirectType(baumer::pixelFormatNames[i].format, baumer::convert_options()) >= 0;
+		for (const cv::Size& size : sizes) {
+			for (int zeroCopy = 0; zeroCopy <= (direct ? 1 : 0); zeroCopy++) {
+				if (run(fp, format, size, zeroCopy != 0, frames, first)) {
+					first = false;
+				} else {
+					ok = false;
+				}
+				fflush(fp);
+			}
+		}
+	}
+	fprintf(fp, "\n\t]\n}\n");
+
+	if (fp != stdout)fclose(fp);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -10,6 +10,8 @@ int main() {
 		//G[Ȃ̂ŏI
 		exit(EXIT_FAILURE);
 	}
+	//ꂽJ͖߂玩ŊJ(ĂԂ͂̃JreadfalseԂ)
+	cap.startDeviceMonitor();
 
 
 	//ڑĂJ̐擾
@@ -19,31 +21,32 @@ int main() {
 		std::cout << cap[i].getDisplayName() << " " << cap[i].getModel() << "[" << cap[i].getSerialNumber() << "]" << std::endl;
 		//J̉ʃTCY
 		std::cout << cap[i].getSize() << std::endl;
+		//~܂Jő̃J̕\xȂ悤,҂Ԃt[Ԋuɍ킹
+		cap[i].setAdaptiveTimeout(true);
+		//\p̔̑傫̉摜ϊƓɍ
+		cap[i].setPyramid(1);
 	}
 
+	//JƂ̏k摜(񓯂̈g)
+	std::vector<std::vector<cv::Mat>> pyramids(camera_number);
+
 
 	//C[v
 	while (true) {
 
-		bool frameNotEmpty = true;
 		//JƂɏ
 		for (int i = 0; i < camera_number; i++) {
 			cv::Mat frame;
 			//J摜擾
-			if (!cap[i].read(frame)) {
-				//摜擾łȂߏI
-				frameNotEmpty = false;
-				break;
+			if (!cap[i].read(frame, pyramids[i])) {
+				//^CAEgȂǂŎ擾łȂJ͍͔΂
+				continue;
 			}
 
-			//摜kĕ\
-			cv::resize(frame, frame, cv::Size(), 0.5, 0.5);
-			cv::imshow("frame" + std::to_string(i), frame);
+			//k摜\
+			cv::imshow("frame" + std::to_string(i), pyramids[i].size() > 1 ? pyramids[i][1] : frame);
 		}
 
-		//1ȏ̃J摜擾łȂߏI
-		if (!frameNotEmpty)break;
-
 		//L[͂ΏI
 		int key = cv::waitKey(10);
 		if (key != -1)break;
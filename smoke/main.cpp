@@ -0,0 +1,275 @@
+#ifndef RSDLAB_BAUMER_USE_SIMULATOR
+#define RSDLAB_BAUMER_USE_SIMULATOR
+#endif
+#include <opencv2/opencv.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Baumer.h"
+
+/*
+* ͋[JgmF
+* J̖(CIȂ),SẴsNZtH[}bg̓ǂݍ,[Rs[̉摜̎,gKƃo[Xg,
+* ̍Đڑ,ϊv[gL^̏Ԃm߂. mF1łs0ȊOŏI
+* g: smoke
+*/
+
+static int failures = 0;
+
+/**
+* mFʂ̏o
+* @param[in] ok 
+* @param[in] name mFe
+* @return bool ok̂܂ܕԂ
+*/
+static bool check(bool ok, const std::string& name) {
+	printf("%s %s\n", ok ? "ok  " : "FAIL", name.c_str());
+	fflush(stdout);
+	if (!ok)failures++;
+	return ok;
+}
+
+/**
+* ͋[J̐ݒ̍쐬
+* @param[in] format sNZtH[}bg
+* @param[in] fps t[[g(0Ȃ擾̑xŐ)
+* @return baumer::simulator_config ݒ
+*/
+static baumer::simulator_config makeConfig(const char* format, double fps) {
+	baumer::simulator_config config;
+	config.width = 64;
+	config.height = 48;
+	config.fps = fps;
+	config.pixelFormats.push_back(format);
+	return config;
+}
+
+/**
+* 2̉摜̒g
+* @param[in] a 摜
+* @param[in] b 摜
+* @return bool 傫,^,f
+*/
+static bool sameImage(const cv::Mat& a, const cv::Mat& b) {
+	if (a.rows != b.rows || a.cols != b.cols || a.type() != b.type())return false;
+	size_t rowSize = a.cols * a.elemSize();
+	for (int y = 0; y < a.rows; y++) {
+		if (memcmp(a.ptr(y), b.ptr(y), rowSize) != 0)return false;
+	}
+	return true;
+}
+
+/**
+* SẴsNZtH[}bg̓ǂݍ݂ƃ^f[^
+*/
+static void checkFormats() {
+	for (size_t i = 0; i < sizeof(baumer::pixelFormatNames) / sizeof(baumer::pixelFormatNames[0]); i++) {
+		//ʖ(BGR8PackedȂ)͓ɂȂ邽1xm߂
+		bool duplicate = false;
+		for (size_t j = 0; j < i; j++) {
+			duplicate |= baumer::pixelFormatNames[j].format == baumer::pixelFormatNames[i].format;
+		}
+		if (duplicate)continue;
+
+		const char* name = baumer::pixelFormatNames[i].name;
+		baumer::pixel_format format = baumer::pixelFormatNames[i].format;
+		baumer::simulator::setCameras(1, makeConfig(name, 0));
+		baumer::VideoCapture cap;
+		if (!check(cap.size() == 1 && cap.start(), std::string("open ") + name))continue;
+
+		int channels = baumer::isBayer(format) || baumer::isBGR(format) ? 3 : 1;
+		int depth = baumer::getSourceBits(format) == 8 ? CV_8U : CV_16U;
+		bool ok = true;
+		bo_uint64 lastID = 0;
+		bo_uint64 lastTimestamp = 0;
+		for (int n = 0; n < 5 && ok; n++) {
+			cv::Mat frame;
+			baumer::frame_info info;
+			ok &= cap[0].read(frame, info, 1000);
+			ok &= frame.cols == 64 && frame.rows == 48 && frame.type() == CV_MAKETYPE(depth, channels);
+			ok &= info.width == 64 && info.height == 48 && !info.incomplete && info.hostTimestamp != 0;
+			ok &= baumer::toPixelFormat(info.pixelFormat) == format;
+			ok &= n == 0 || (info.frameID > lastID && info.timestamp > lastTimestamp);
+			lastID = info.frameID;
+			lastTimestamp = info.timestamp;
+		}
+		check(ok, std::string("read ") + name);
+		cap.stop();
+	}
+}
+
+/**
+* [Rs[̉摜ێĂԂ̓obt@ăL[ꂸ,Ɩ߂邱
+*/
+static void checkZeroCopy() {
+	baumer::simulator::setCameras(1, makeConfig("Mono8", 0));
+	baumer::VideoCapture cap;
+	if (!check(cap.size() == 1 && cap.start(), "open zero-copy"))return;
+	cap[0].setZeroCopy(true, 2);
+
+	//ێĂ摜͌̓ǂݍ݂ŏ㏑Ȃ
+	cv::Mat held;
+	bool ok = cap[0].read(held, 1000) && cap[0].getHeldBuffers() == 1;
+	cv::Mat copy = held.clone();
+	cv::Mat frame;
+	for (int i = 0; i < 20 && ok; i++) {
+		ok &= cap[0].read(frame, 1000);
+		frame.release();
+	}
+	ok &= sameImage(held, copy);
+	held.release();
+	ok &= cap[0].getHeldBuffers() == 0;
+	check(ok, "zero-copy Mat keeps its buffer until released");
+
+	//obt@͍ăL[,obt@葽ǂ߂
+	ok = true;
+	for (int i = 0; i < 3 * cap[0].getBufferPool().count && ok; i++) {
+		ok &= cap[0].read(frame, 1000);
+		frame.release();
+	}
+	check(ok && cap[0].getHeldBuffers() == 0, "zero-copy buffers are requeued");
+
+	//ێ܂܂̍ĊJƃobt@̍蒼
+	ok = cap[0].read(held, 1000);
+	copy = held.clone();
+	ok &= cap[0].stopCamera() && cap[0].startCamera();
+	for (int i = 0; i < 10 && ok; i++) {
+		ok &= cap[0].read(frame, 1000);
+		frame.release();
+	}
+	baumer::buffer_pool_config pool = cap[0].getBufferPool();
+	pool.count++;
+	ok &= cap[0].setBufferPool(pool);
+	ok &= sameImage(held, copy);
+	held.release();
+	ok &= cap[0].getHeldBuffers() == 0;
+	for (int i = 0; i < 10 && ok; i++) {
+		ok &= cap[0].read(frame, 1000);
+		frame.release();
+	}
+	check(ok, "zero-copy Mat survives restart and buffer reallocation");
+	cap.stop();
+}
+
+/**
+* \tgEFAgKƃo[Xg̖
+*/
+static void checkTrigger() {
+	baumer::simulator::setCameras(2, makeConfig("Mono8", 0));
+	baumer::VideoCapture cap;
+	if (!check(cap.size() == 2 && cap.setTriggerMode(true) && cap.start(), "open trigger"))return;
+
+	//gKƂɑSẴJ1ǂ,]ȉ摜͗Ȃ
+	bool ok = true;
+	cv::Mat frame;
+	for (int i = 0; i < 5 && ok; i++) {
+		ok &= cap.trigger();
+		for (size_t c = 0; c < cap.size(); c++) {
+			ok &= cap[(int)c].read(frame, 1000);
+		}
+	}
+	for (size_t c = 0; c < cap.size(); c++) {
+		ok &= !cap[(int)c].read(frame, 200);
+	}
+	check(ok, "one frame per software trigger on every camera");
+
+	ok = cap[0].setBurst(3) && cap[0].executeSoftwareTrigger();
+	baumer::frame_batch batch;
+	ok &= cap[0].readBurst(batch) && batch.count == 3;
+	ok &= !cap[0].read(frame, 200);
+	check(ok, "burst of 3 frames per trigger");
+	cap.stop();
+}
+
+/**
+* ̍ĐڑƓv
+* (v̏osē,ւƓv̓ǂݏodȂ悤ɂ)
+*/
+static void checkReconnect() {
+	baumer::simulator_config config = makeConfig("Mono8", 200);
+	baumer::simulator::setCameras(1, config);
+	std::string serial = config.serialNumber + "0";
+	std::string statsPath = "smoke_stats.prom";
+
+	baumer::VideoCapture cap;
+	if (!check(cap.size() == 1 && cap.start(), "open reconnect"))return;
+	cap.startDeviceMonitor(20);
+	cap.startStatsExporter(statsPath, 1);
+
+	cv::Mat frame;
+	bool ok = cap[0].read(frame, 1000);
+	baumer::simulator::setConnected(serial, false);
+	uint64_t deadline = baumer::steadyNow() + 3000000000ULL;
+	while (cap[0].read(frame, 50) && baumer::steadyNow() < deadline) {}
+	ok &= !cap[0].isConnected();
+	check(ok, "unplugged camera stops reading");
+
+	baumer::simulator::setConnected(serial, true);
+	deadline = baumer::steadyNow() + 5000000000ULL;
+	bool resumed = false;
+	while (!resumed && baumer::steadyNow() < deadline) {
+		resumed = cap[0].read(frame, 50);
+	}
+	baumer::device_stats stats = cap[0].getStats();
+	check(resumed && cap[0].isConnected() && stats.disconnects == 1 && stats.reconnects == 1, "replugged camera is reopened and counted");
+
+	cap.stopStatsExporter();
+	cap.stopDeviceMonitor();
+	std::ifstream ifs(statsPath);
+	std::stringstream text;
+	text << ifs.rdbuf();
+	check(text.str().find("baumer_device_reconnects_total{serial=\"" + serial + "\"} 1") != std::string::npos, "exported stats include the reconnect");
+	ifs.close();
+	std::remove(statsPath.c_str());
+	cap.stop();
+}
+
+/**
+* ϊv[g擾̋L^J̎󂯎菇ɂȂ邱
+*/
+static void checkRecordingOrder() {
+	baumer::simulator::setCameras(1, makeConfig("BayerRG8", 0));
+	std::string path = "smoke_record.raw";
+
+	baumer::VideoCapture cap;
+	if (!check(cap.size() == 1, "open recording"))return;
+	baumer::buffer_pool_config pool = cap[0].getBufferPool();
+	pool.count = 16;
+	bool ok = cap[0].setBufferPool(pool) && cap[0].startRecording(path, 64 << 20);
+	ok &= cap.start() && cap[0].startGrabbing(8, baumer::overflow_policy::block, 1000, std::make_shared<baumer::convert_pool>(4));
+	cv::Mat frame;
+	for (int i = 0; i < 200 && ok; i++) {
+		ok &= cap[0].read(frame, 1000);
+	}
+	ok &= cap[0].stopGrabbing() && cap[0].stopRecording();
+	cap.stop();
+
+	baumer::raw_reader reader;
+	int records = 0;
+	if (ok && reader.open(path)) {
+		bo_uint64 lastID = 0;
+		while (const baumer::raw_record_header* r = reader.next()) {
+			ok &= records == 0 || r->frameID > lastID;
+			lastID = r->frameID;
+			records++;
+		}
+	}
+	check(ok && records >= 200, "pooled recording keeps acquisition order (" + std::to_string(records) + " records)");
+	std::remove(path.c_str());
+}
+
+int main() {
+	checkFormats();
+	checkZeroCopy();
+	checkTrigger();
+	checkReconnect();
+	checkRecordingOrder();
+
+	printf("%d failure(s)\n", failures);
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
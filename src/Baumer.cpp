@@ -1,56 +1,484 @@
 #include "Baumer.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <future>
+#include <algorithm>
 
 namespace baumer {
 	VideoCapture::VideoCapture() {
-		openSystem();
+		openSystem(open_options());
+	}
+
+	VideoCapture::VideoCapture(const open_options& options) {
+		openSystem(options);
 	}
 
 	VideoCapture::~VideoCapture() {
+		stopStatsExporter();
+		stopDeviceMonitor();
+		this->triggerGate.reset();
+		for (auto& link : this->monitorLinks) {
+			link->sweep(true);
+		}
+		//擾XbhƃCxgobt@ɐGȂȂĂ
+		for (auto& cam : this->cameras) {
+			cam.shutdown();
+		}
 		try {
-			for (auto cam : this->cameras) {
+			saveConfigCache();
+
+			for (auto& cam : this->cameras) {
+				if (!cam.isConnected())continue;
 				cam.close();
 			}
-			this->deviceList.close();
-			this->interfaceList.close();
+			for (auto& devices : this->deviceLists) {
+				devices.close();
+			}
+			for (auto& interfaces : this->interfaceLists) {
+				interfaces.close();
+			}
 			this->systemList.close();
 		} catch (BGAPI2::Exceptions::IException& ex) {
 
 		}
 	}
 
-	bool VideoCapture::openSystem() {
+	bool VideoCapture::openSystem(const open_options& options) {
+		std::launch policy = options.parallel ? std::launch::async : std::launch::deferred;
+		if (!options.configCache.empty()) {
+			configCachePath = options.configCache;
+			configCache = loadConfigCache(configCachePath);
+		}
+#ifdef RSDLAB_BAUMER_USE_SIMULATOR
+		if (!options.playbackFiles.empty()) {
+			simulator::setPlayback(options.playbackFiles, options.playback, options.playbackFps, options.playbackLoop);
+		}
+#endif
 		systemList.initInstance();
+
+		//C^[tF[Ẍꗗ(System͏Ȃ̂ŏɊJ)
+		std::vector<BGAPI2::InterfaceList::iterator> interfaces;
 		for (auto it_s = systemList.begin(); it_s != systemList.end(); it_s++) {
-			if (!interfaceList.set(it_s))continue;
+			baumer_interface_list interfaceList;
+			if (!interfaceList.set(it_s, options.refreshTimeout))continue;
+			this->interfaceLists.push_back(interfaceList);
 			for (auto it_i = interfaceList.begin(); it_i != interfaceList.end(); it_i++) {
-				if (!deviceList.set(it_i))continue;
-				for (auto it_d = deviceList.begin(); it_d != deviceList.end(); it_d++) {
-					baumer_device dev;
-					if(!dev.set(it_d))continue;
-					this->cameras.push_back(dev);
-				}
+				interfaces.push_back(it_i);
 			}
 		}
+
+		//C^[tF[XƂɃfoCX,foCXƂɏݒ肷
+		std::mutex readyMutex;
+		std::vector<std::pair<unsigned long long, baumer_device>> ready;
+		std::vector<char> found(interfaces.size(), 0);
+		this->deviceLists.resize(interfaces.size());
+
+		std::vector<std::future<void>> interfaceTasks;
+		for (size_t i = 0; i < interfaces.size(); i++) {
+			interfaceTasks.push_back(std::async(policy, [&, i] {
+				baumer_device_list& deviceList = this->deviceLists[i];
+				if (!deviceList.set(interfaces[i], options.refreshTimeout))return;
+				found[i] = 1;
+
+				std::vector<std::future<void>> deviceTasks;
+				unsigned long long n = 0;
+				for (auto it_d = deviceList.begin(); it_d != deviceList.end(); it_d++, n++) {
+					std::string serial;
+					if (!options.serialNumbers.empty() || !configCache.empty()) {
+						try {
+							serial = it_d->second->GetSerialNumber().get();
+						} catch (BGAPI2::Exceptions::IException& ex) { continue; }
+					}
+					if (!options.serialNumbers.empty() &&
+						std::find(options.serialNumbers.begin(), options.serialNumbers.end(), serial) == options.serialNumbers.end())continue;
+
+					auto cached = configCache.find(serial);
+					const device_config* config = cached == configCache.end() ? NULL : &cached->second;
+
+					unsigned long long order = ((unsigned long long)i << 32) | n;
+					deviceTasks.push_back(std::async(policy, [&, it_d, order, config] {
+						baumer_device dev;
+						if (!dev.set(it_d, config))return;
+
+						std::lock_guard<std::mutex> lock(readyMutex);
+						if (options.onReady)options.onReady(dev);
+						ready.emplace_back(order, dev);
+					}));
+				}
+				for (auto& task : deviceTasks) {
+					task.wait();
+				}
+			}));
+		}
+		for (auto& task : interfaceTasks) {
+			task.wait();
+		}
+
+		//JȂC^[tF[X͕ΏۂO
+		std::vector<baumer_device_list> opened;
+		for (size_t i = 0; i < found.size(); i++) {
+			if (found[i])opened.push_back(this->deviceLists[i]);
+		}
+		this->deviceLists.swap(opened);
+
+		std::sort(ready.begin(), ready.end(), [](const std::pair<unsigned long long, baumer_device>& a, const std::pair<unsigned long long, baumer_device>& b) {
+			return a.first < b.first;
+		});
+		bool probed = false;
+		for (auto& dev : ready) {
+			this->cameras.push_back(dev.second);
+			probed |= !dev.second.isFromCache();
+		}
+		//TJΎ̂߂ɕۑ
+		if (probed)saveConfigCache();
+
 		if (this->cameras.size() == 0)return false;
 		return true;
 	}
 
 	bool VideoCapture::start() {
 		bool canStartCam = this->cameras.size() > 0;
-		for (auto cam : this->cameras) {
+		for (auto& cam : this->cameras) {
 			canStartCam &= cam.startCamera();
 		}
 
 		return canStartCam;
 	}
 
+	bool VideoCapture::startGrabbing(int capacity, overflow_policy policy, std::shared_ptr<convert_pool> pool) {
+		bool canStartGrab = this->cameras.size() > 0;
+		for (auto& cam : this->cameras) {
+			canStartGrab &= cam.startGrabbing(capacity, policy, 1000, pool);
+		}
+
+		return canStartGrab;
+	}
+
+	bool VideoCapture::readSynchronized(std::vector<cv::Mat>& frames, bo_uint64 tolerance, int timeout) {
+		std::vector<frame_info> infos;
+		return readSynchronized(frames, infos, tolerance, timeout);
+	}
+
+	bool VideoCapture::readSynchronized(std::vector<cv::Mat>& frames, std::vector<frame_info>& infos, bo_uint64 tolerance, int timeout) {
+		size_t n = this->cameras.size();
+		if (n == 0)return false;
+		if (syncPending.size() != n) {
+			syncPending.assign(n, baumer_device::grabbed_frame());
+			syncHas.assign(n, false);
+		}
+		for (auto& cam : this->cameras) {
+			if (!cam.isGrabbing() && !cam.startGrabbing())return false;
+		}
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+		while (true) {
+			//ȂJ̉摜[
+			for (size_t i = 0; i < n; i++) {
+				if (syncHas[i])continue;
+				auto begin = std::chrono::steady_clock::now();
+				int remain = (int)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - begin).count();
+				if (remain <= 0) {
+					syncStats.timeouts++;
+					return false;
+				}
+				if (!this->cameras[i].readStamped(syncPending[i], remain)) {
+					//҂Ԃg؂炸Ɏŝ̓^CAEgƂ͕Đ
+					if (std::chrono::steady_clock::now() - begin >= std::chrono::milliseconds(remain)) {
+						syncStats.timeouts++;
+					} else {
+						syncStats.errors++;
+						std::cerr << "Error: Synchronized read failed on camera " << i << std::endl;
+					}
+					return false;
+				}
+				syncHas[i] = true;
+			}
+
+			bo_uint64 newest = syncPending[0].info.timestamp;
+			bo_uint64 oldest = syncPending[0].info.timestamp;
+			for (size_t i = 1; i < n; i++) {
+				if (syncPending[i].info.timestamp > newest)newest = syncPending[i].info.timestamp;
+				if (syncPending[i].info.timestamp < oldest)oldest = syncPending[i].info.timestamp;
+			}
+
+			if (newest - oldest <= tolerance) {
+				frames.resize(n);
+				infos.resize(n);
+				for (size_t i = 0; i < n; i++) {
+					frames[i] = syncPending[i].mat;
+					infos[i] = syncPending[i].info;
+					syncPending[i].mat.release();
+					syncHas[i] = false;
+				}
+
+				bo_uint64 skew = newest - oldest;
+				syncStats.matched++;
+				syncSkewSum += skew;
+				if (skew > syncStats.maxSkew)syncStats.maxSkew = skew;
+				syncStats.meanSkew = (double)syncSkewSum / syncStats.matched;
+				syncStats.matchRate = (double)(syncStats.matched * n) / (syncStats.matched * n + syncStats.dropped);
+				return true;
+			}
+
+			//ŐV̉摜狖e͈͊ǑÂ摜̂ĂĎ蒼
+			for (size_t i = 0; i < n; i++) {
+				if (newest - syncPending[i].info.timestamp > tolerance) {
+					syncPending[i].mat.release();
+					syncHas[i] = false;
+					syncStats.dropped++;
+				}
+			}
+			syncStats.matchRate = syncStats.matched == 0 ? 0 : (double)(syncStats.matched * n) / (syncStats.matched * n + syncStats.dropped);
+		}
+	}
+
+	bool VideoCapture::setTriggerMode(bool enable, BGAPI2::String source) {
+		bool canSet = this->cameras.size() > 0;
+		for (auto& cam : this->cameras) {
+			if (source != "")canSet &= cam.setTriggerSource(source);
+			canSet &= cam.setTriggerMode(enable);
+		}
+
+		return canSet;
+	}
+
+	bool VideoCapture::trigger() {
+		size_t n = this->cameras.size();
+		if (n == 0)return false;
+		if (n == 1)return this->cameras[0].executeSoftwareTrigger();
+
+		//ҋ@ĂJƂ̃XbhňĂɎs
+		if (!this->triggerGate || this->triggerGate->size() != n) {
+			this->triggerGate.reset(new trigger_gate(n, [this](size_t i) {
+				return this->cameras[i].executeSoftwareTrigger();
+			}));
+		}
+		return this->triggerGate->fire();
+	}
+
 	bool VideoCapture::stop() {
 		bool canStopCam = true;
-		for (auto cam : this->cameras) {
+		for (auto& cam : this->cameras) {
+			cam.stopGrabbing();
 			canStopCam &= cam.stopCamera();
 		}
 
 		return canStopCam;
 	}
+
+	bool VideoCapture::saveConfigCache() {
+		if (configCachePath.empty())return false;
+		for (auto& cam : this->cameras) {
+			try {
+				device_config config = cam.getConfig();
+				configCache[config.serialNumber] = config;
+			} catch (BGAPI2::Exceptions::IException& ex) {}
+		}
+		return baumer::saveConfigCache(configCachePath, configCache);
+	}
+
+	std::string VideoCapture::getStatsText() {
+		struct counter_metric {
+			const char* name;
+			const char* type;
+			const char* help;
+			uint64_t device_stats::* field;
+		};
+		static const counter_metric counters[] = {
+			{ "baumer_frames_delivered_total", "counter", "Frames delivered by read()", &device_stats::delivered },
+			{ "baumer_frames_incomplete_total", "counter", "Incomplete frames discarded", &device_stats::incomplete },
+			{ "baumer_buffer_timeouts_total", "counter", "GetFilledBuffer timeouts", &device_stats::timeouts },
+			{ "baumer_frames_lost_total", "counter", "Frames missing from the FrameID sequence", &device_stats::lost },
+			{ "baumer_read_errors_total", "counter", "Reads aborted by an exception", &device_stats::errors },
+			{ "baumer_driver_delivered_total", "counter", "Frames delivered by the driver", &device_stats::driverDelivered },
+			{ "baumer_driver_underrun_total", "counter", "Frames dropped by the driver for lack of a free buffer", &device_stats::driverUnderrun },
+			{ "baumer_driver_lost_total", "counter", "Frames reported lost by the driver", &device_stats::driverLost },
+			{ "baumer_driver_queued_buffers", "gauge", "Free buffers queued to the driver", &device_stats::driverQueued },
+			{ "baumer_driver_await_delivery_buffers", "gauge", "Filled buffers waiting in the driver output queue", &device_stats::driverAwaitDelivery },
+			{ "baumer_grab_queued_frames", "gauge", "Frames waiting in the grab thread ring", &device_stats::grabQueued },
+			{ "baumer_grab_dropped_total", "counter", "Frames dropped by the grab thread ring", &device_stats::grabDropped },
+			{ "baumer_device_connected", "gauge", "1 while the camera is connected, 0 after it was unplugged", &device_stats::connected },
+			{ "baumer_device_disconnects_total", "counter", "Times the camera was found unplugged", &device_stats::disconnects },
+			{ "baumer_device_reconnects_total", "counter", "Times the camera was reopened and reading resumed", &device_stats::reconnects }
+		};
+		struct summary_metric {
+			const char* name;
+			const char* help;
+			latency_summary device_stats::* field;
+		};
+		static const summary_metric summaries[] = {
+			{ "baumer_convert_seconds", "Time from buffer receipt to converted image", &device_stats::convert },
+			{ "baumer_latency_seconds", "Time from buffer receipt to hand-over to the application", &device_stats::latency },
+			{ "baumer_recovery_seconds", "Time from detecting an unplugged camera to resuming reads", &device_stats::recovery }
+		};
+
+		std::vector<device_stats> stats;
+		std::vector<std::string> serials;
+		for (auto& cam : this->cameras) {
+			stats.push_back(cam.getStats());
+			//JJւ̍ւƏdȂĂ悢悤,foCXł͂ȂNǂ
+			serials.push_back(cam.link ? cam.link->serialNumber : std::string(cam.getSerialNumber().get()));
+		}
+
+		std::ostringstream out;
+		for (const auto& m : counters) {
+			out << "# HELP " << m.name << " " << m.help << "\n";
+			out << "# TYPE " << m.name << " " << m.type << "\n";
+			for (size_t i = 0; i < stats.size(); i++) {
+				out << m.name << "{serial=\"" << serials[i] << "\"} " << stats[i].*m.field << "\n";
+			}
+		}
+		for (const auto& m : summaries) {
+			out << "# HELP " << m.name << " " << m.help << "\n";
+			out << "# TYPE " << m.name << " summary\n";
+			for (size_t i = 0; i < stats.size(); i++) {
+				const latency_summary& s = stats[i].*m.field;
+				std::string label = "{serial=\"" + serials[i] + "\"";
+				out << m.name << label << ",quantile=\"0.5\"} " << s.p50 * 1e-9 << "\n";
+				out << m.name << label << ",quantile=\"0.99\"} " << s.p99 * 1e-9 << "\n";
+				out << m.name << label << ",quantile=\"0.999\"} " << s.p999 * 1e-9 << "\n";
+				out << m.name << "_sum" << label << "} " << s.mean * s.count * 1e-9 << "\n";
+				out << m.name << "_count" << label << "} " << s.count << "\n";
+			}
+		}
+		return out.str();
+	}
+
+	bool VideoCapture::startStatsExporter(const std::string& path, int intervalMs) {
+		if (exporting)return false;
+		exporting = true;
+		exporter = std::thread([this, path, intervalMs] {
+			std::string tmp = path + ".tmp";
+			std::unique_lock<std::mutex> lock(exporterMutex);
+			while (exporting) {
+				{
+					std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+					ofs << getStatsText();
+				}
+				std::remove(path.c_str());
+				std::rename(tmp.c_str(), path.c_str());
+				exporterCond.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return !exporting; });
+			}
+		});
+		return true;
+	}
+
+	void VideoCapture::stopStatsExporter() {
+		{
+			std::lock_guard<std::mutex> lock(exporterMutex);
+			exporting = false;
+		}
+		exporterCond.notify_all();
+		if (exporter.joinable())exporter.join();
+	}
+
+	bool VideoCapture::startDeviceMonitor(int intervalMs, device_event_handler handler) {
+		if (monitoring)return false;
+
+		//ꂽƂɕێĂȂl₤,ڑɐݒǂł
+		this->monitorLinks.clear();
+		for (auto& cam : this->cameras) {
+			if (!cam.link)continue;
+			try {
+				cam.link->config = cam.getConfig();
+			} catch (BGAPI2::Exceptions::IException& ex) {}
+			this->monitorLinks.push_back(cam.link);
+		}
+
+		monitoring = true;
+		monitor = std::thread([this, intervalMs, handler] {
+			std::vector<std::string> arrived;
+			std::unique_lock<std::mutex> lock(monitorMutex);
+			while (monitoring) {
+				lock.unlock();
+				pollDevices(arrived, handler);
+				lock.lock();
+				monitorCond.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return !monitoring; });
+			}
+		});
+		return true;
+	}
+
+	void VideoCapture::stopDeviceMonitor() {
+		{
+			std::lock_guard<std::mutex> lock(monitorMutex);
+			monitoring = false;
+		}
+		monitorCond.notify_all();
+		if (monitor.joinable())monitor.join();
+		for (auto& link : this->monitorLinks) {
+			link->sweep(false);
+		}
+	}
+
+	void VideoCapture::pollDevices(std::vector<std::string>& arrived, const device_event_handler& handler) {
+		typedef baumer_device::device_link link_type;
+
+		//ڑĂJ(ꗗXVłȂC^[tF[XΔꂽƌFȂ悤͌)
+		std::map<std::string, BGAPI2::DeviceList::iterator> present;
+		for (auto& devices : this->deviceLists) {
+			try {
+				devices.deviceList->Refresh(100);
+				for (auto it = devices.begin(); it != devices.end(); it++) {
+					present[it->second->GetSerialNumber().get()] = it;
+				}
+			} catch (BGAPI2::Exceptions::IException& ex) {
+				return;
+			}
+		}
+
+		for (auto& link : this->monitorLinks) {
+			auto found = present.find(link->serialNumber);
+			int state = link->state.load(std::memory_order_acquire);
+
+			if (state == link_type::connected && found == present.end()) {
+				{
+					std::lock_guard<std::mutex> lock(link->mutex);
+					link->lostAt = steadyNow();
+					link->state = link_type::lost;
+				}
+				device_counters::add(link->counters->disconnects);
+				if (handler)handler(link->serialNumber, device_event::removed);
+			} else if (state == link_type::lost && found != present.end()) {
+				//ǂݍݑꂽJ̃Rs[ĂJ
+				std::shared_ptr<baumer_device> old;
+				{
+					std::lock_guard<std::mutex> lock(link->mutex);
+					old = link->previous;
+				}
+				if (old) {
+					std::shared_ptr<baumer_device> dev = std::make_shared<baumer_device>();
+					device_config config = old->getCachedConfig();
+					if (dev->set(found->second, &config)) {
+						dev->link = link;
+						if (dev->inherit(*old)) {
+							{
+								std::lock_guard<std::mutex> lock(link->mutex);
+								link->replacement = dev;
+								link->state = link_type::ready;
+							}
+							if (handler)handler(link->serialNumber, device_event::reconnected);
+						} else {
+							dev->retire();
+						}
+					}
+				}
+			}
+			link->sweep(false);
+		}
+
+		//JĂȂJ͈xʒm
+		std::vector<std::string> still;
+		for (auto& p : present) {
+			bool opened = std::any_of(this->monitorLinks.begin(), this->monitorLinks.end(), [&](const std::shared_ptr<link_type>& link) {
+				return link->serialNumber == p.first;
+			});
+			if (opened)continue;
+			if (handler && std::find(arrived.begin(), arrived.end(), p.first) == arrived.end())handler(p.first, device_event::arrived);
+			still.push_back(p.first);
+		}
+		arrived.swap(still);
+	}
 }
\ No newline at end of file
@@ -7,11 +7,788 @@
 #endif
 
 #include <vector>
+#include <map>
+#include <set>
 #include <exception>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <functional>
+#include <deque>
 #include <opencv2/opencv.hpp>
+#ifdef RSDLAB_BAUMER_USE_SIMULATOR
+#include "BaumerSimulator.h"
+#else
 #include "bgapi2_genicam/bgapi2_genicam.hpp"
+#endif
+#include "BaumerConvert.h"
+#include "BaumerStats.h"
+#include "BaumerRecorder.h"
+#include "BaumerExposure.h"
+
+//C++20̃R[`gꍇnextFrame()񋟂
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define RSDLAB_BAUMER_COROUTINE
+#endif
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#define RSDLAB_BAUMER_UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef RSDLAB_BAUMER_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef RSDLAB_BAUMER_UNDEF_NOMINMAX
+#endif
+#else
+#include <sys/mman.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#endif
 
 namespace baumer {
+	/**
+	* 擾obt@v[̐ݒ
+	*/
+	struct buffer_pool_config {
+		int count = 4;				//obt@
+		bool userMemory = false;	//[U[Ŋmۂg(falseȂhCom)
+		size_t alignment = 4096;	//ACg(y[WTCY)
+		bool hugePages = false;		//q[Wy[W(WindowsLarge Page)g
+		bool numaLocal = false;		//ĂяoXbhNUMAm[hɊmۂ邩
+	};
+
+	/**
+	* JƂ̐ݒLbV
+	* Ñm[h̒TȂ,O̐ݒ𕜌邽߂Ɏg
+	*/
+	struct device_config {
+		std::string serialNumber;		//VAio[
+		std::string firmwareVersion;	//t@[EFAo[W(vȂ΃LbVgȂ)
+		std::string pixelFormat;		//sNZtH[}bg
+		std::string exposureNodeName;	//IԂ̃m[h
+		double exposureMin = 0;			//IԂ̍ŏl
+		double exposureMax = 0;			//IԂ̍ől
+		bool hasGain = false;			//QCݒł邩
+		double gainMin = 0;				//QC̍ŏl
+		double gainMax = 0;				//QC̍ől
+		double exposure = 0;			//I
+		double gain = 0;				//QC
+		cv::Rect roi;					//ROI
+		int bufferCount = 4;			//obt@
+
+		/**
+		* 
+		* @param[in] fs ݐ(V[PX̒ŌĂ)
+		*/
+		void write(cv::FileStorage& fs) const {
+			fs << "{";
+			fs << "serialNumber" << serialNumber;
+			fs << "firmwareVersion" << firmwareVersion;
+			fs << "pixelFormat" << pixelFormat;
+			fs << "exposureNodeName" << exposureNodeName;
+			fs << "exposureMin" << exposureMin;
+			fs << "exposureMax" << exposureMax;
+			fs << "hasGain" << (int)hasGain;
+			fs << "gainMin" << gainMin;
+			fs << "gainMax" << gainMax;
+			fs << "exposure" << exposure;
+			fs << "gain" << gain;
+			fs << "roi" << roi;
+			fs << "bufferCount" << bufferCount;
+			fs << "}";
+		}
+
+		/**
+		* ǂݍ
+		* @param[in] node ǂݍ݌
+		*/
+		void read(const cv::FileNode& node) {
+			node["serialNumber"] >> serialNumber;
+			node["firmwareVersion"] >> firmwareVersion;
+			node["pixelFormat"] >> pixelFormat;
+			node["exposureNodeName"] >> exposureNodeName;
+			node["exposureMin"] >> exposureMin;
+			node["exposureMax"] >> exposureMax;
+			hasGain = (int)node["hasGain"] != 0;
+			node["gainMin"] >> gainMin;
+			node["gainMax"] >> gainMax;
+			node["exposure"] >> exposure;
+			node["gain"] >> gain;
+			node["roi"] >> roi;
+			node["bufferCount"] >> bufferCount;
+		}
+	};
+
+	/**
+	* ݒLbV̓ǂݍ
+	* @param[in] path t@C(cv::FileStorageň`)
+	* @return std::map<std::string, device_config> VAio[Ƃ̐ݒ(ǂ߂Ȃ΋)
+	*/
+	inline std::map<std::string, device_config> loadConfigCache(const std::string& path) {
+		std::map<std::string, device_config> configs;
+		try {
+			cv::FileStorage fs(path, cv::FileStorage::READ);
+			if (!fs.isOpened())return configs;
+			cv::FileNode cameras = fs["cameras"];
+			for (auto it = cameras.begin(); it != cameras.end(); ++it) {
+				device_config config;
+				config.read(*it);
+				if (!config.serialNumber.empty())configs[config.serialNumber] = config;
+			}
+		} catch (cv::Exception& e) {
+			configs.clear();
+		}
+		return configs;
+	}
+
+	/**
+	* ݒLbV̕ۑ
+	* @param[in] path t@C(cv::FileStorageň`)
+	* @param[in] configs VAio[Ƃ̐ݒ
+	* @return bool ۑł
+	*/
+	inline bool saveConfigCache(const std::string& path, const std::map<std::string, device_config>& configs) {
+		try {
+			cv::FileStorage fs(path, cv::FileStorage::WRITE);
+			if (!fs.isOpened())return false;
+			fs << "cameras" << "[";
+			for (const auto& config : configs) {
+				config.second.write(fs);
+			}
+			fs << "]";
+		} catch (cv::Exception& e) {
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	* OuXbh̃OꂽƂ̓
+	*/
+	enum class overflow_policy {
+		drop_oldest,	//łÂt[̂Ă
+		drop_newest,	//Vt[̂Ă
+		block			//󂫂ł܂Ŏ擾҂
+	};
+
+	/**
+	* J̔̒ʒm̎
+	*/
+	enum class device_event {
+		removed,		//JĂJꂽ
+		reconnected,	//ꂽJJ(read()ǂݍ߂)
+		arrived			//JĂȂJ
+	};
+
+	/**
+	* 摜Ƃ̃^f[^
+	* ǂݍ݂̂тɊmۂȂ悤Œ蒷PODɂĂ
+	*/
+	struct frame_info {
+		bo_uint64 timestamp = 0;		//J̃^CX^v(ʏnsec)
+		bo_uint64 frameID = 0;			//t[ԍ
+		bo_uint64 hostTimestamp = 0;	//zXgobt@󂯎[nsec](std::chrono::steady_clock)
+		int width = 0;					//
+		int height = 0;					//
+		int offsetX = 0;				//ROI̍X
+		int offsetY = 0;				//ROI̍Y
+		bool incomplete = false;		//]sS
+		char pixelFormat[32] = {};		//J̃sNZtH[}bg
+	};
+
+	/**
+	* 摜ƂɌĂ΂R[obN
+	* (摜͌ĂяôݗLƂ͌炸,ێĂ悢)
+	*/
+	typedef std::function<void(const cv::Mat& frame, const frame_info& info)> frame_callback;
+
+	/**
+	* o[XgBe̓ǂݍݐ
+	* g񂹂悤,vf̓o[Xg菬Ƃ₷
+	*/
+	struct frame_batch {
+		std::vector<cv::Mat> frames;	//摜
+		std::vector<frame_info> infos;	//摜Ƃ̃^f[^
+		size_t count = 0;				//ǂݍ߂
+
+		/**
+		* vf̊m
+		* @param[in] n 
+		*/
+		void reserve(size_t n) {
+			if (frames.size() < n)frames.resize(n);
+			if (infos.size() < n)infos.resize(n);
+		}
+	};
+
+	/**
+	* 1̓ǂݍ݂̋ԂƂ̏v[nsec]
+	* (vLɂƂ̂ݍXV)
+	*/
+	struct read_timing {
+		bo_uint64 wait = 0;			//GetFilledBuffeȓ҂
+		bo_uint64 dispatch = 0;		//^f[^̎擾ƕϊ@̑I
+		bo_uint64 convert = 0;		//WJ,fUCN,^ϊ
+		bo_uint64 shift = 0;		//[Rs[̃rbgVtg
+		bo_uint64 exposure = 0;		//Io̓vƃm[h̍XV
+		bo_uint64 pyramid = 0;		//k摜(s~bh)̐
+		bo_uint64 requeue = 0;		//obt@̍ăL[
+	};
+
+	/**
+	* J̓ǂݍ݂̓v
+	*/
+	struct sync_stats {
+		unsigned long long matched = 0;		//g̐
+		unsigned long long dropped = 0;		//킸Ɏ̂Ă摜
+		unsigned long long timeouts = 0;	//ԓɑȂ
+		unsigned long long errors = 0;		//҂Ԃ̑Oɓǂݍ݂Ɏs(擾̒~ؒf)
+		bo_uint64 maxSkew = 0;				//g̍ő̂(^CX^vP)
+		double meanSkew = 0;				//g̕ς̂(^CX^vP)
+		double matchRate = 0;				//擾摜̂gƂďo͂ꂽ
+	};
+
+	/**
+	* bNt[ȌŒ蒷O(Pvf[T/PRV[})
+	* drop_oldest̂߂Ƀvf[TŌÂ̗vfoƂ
+	*/
+	template<typename T>
+	class spsc_ring {
+	private:
+		struct cell {
+			std::atomic<size_t> seq;
+			T data;
+		};
+		std::unique_ptr<cell[]> cells;
+		size_t mask;
+		alignas(64) std::atomic<size_t> head;
+		alignas(64) std::atomic<size_t> tail;
+
+	public:
+		/**
+		* @param[in] capacity e(2ׂ̂ɐ؂グ)
+		*/
+		explicit spsc_ring(size_t capacity) : head(0), tail(0) {
+			size_t n = 1;
+			while (n < capacity)n <<= 1;
+			cells.reset(new cell[n]);
+			mask = n - 1;
+			for (size_t i = 0; i < n; i++) {
+				cells[i].seq.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		/**
+		* ǉ(vf[T̂)
+		* @param[in] v ǉvf(Ƃ[u)
+		* @return bool 󂫂ǉł
+		*/
+		bool push(T&& v) {
+			size_t pos = head.load(std::memory_order_relaxed);
+			cell& c = cells[pos & mask];
+			if (c.seq.load(std::memory_order_acquire) != pos)return false;
+			c.data = std::move(v);
+			c.seq.store(pos + 1, std::memory_order_release);
+			head.store(pos + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		/**
+		* o
+		* @param[out] v ovf
+		* @return bool vf
+		*/
+		bool pop(T& v) {
+			size_t pos = tail.load(std::memory_order_relaxed);
+			while (true) {
+				cell& c = cells[pos & mask];
+				size_t seq = c.seq.load(std::memory_order_acquire);
+				if (seq == pos + 1) {
+					if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						v = std::move(c.data);
+						c.seq.store(pos + mask + 1, std::memory_order_release);
+						return true;
+					}
+				} else if (seq < pos + 1) {
+					return false;
+				} else {
+					pos = tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/**
+		* i[Ăvf
+		* @return size_t vf
+		*/
+		inline size_t size() const {
+			return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+		}
+
+		/**
+		* e
+		* @return size_t e
+		*/
+		inline size_t capacity() const {
+			return mask + 1;
+		}
+	};
+
+	/**
+	* 擾obt@p̊mۂƉ
+	* startStream/stopStream܂ōėp
+	*/
+	struct buffer_pool {
+	private:
+		struct block {
+			void* ptr;
+			size_t size;
+			bool mapped;
+		};
+		std::vector<block> blocks;
+
+		static size_t roundUp(size_t size, size_t unit) {
+			return unit == 0 ? size : ((size + unit - 1) / unit) * unit;
+		}
+
+	public:
+		/**
+		* m
+		* q[Wy[WmۂłȂꍇ͒ʏ̃y[WɃtH[obN
+		* @param[in] size mۂTCY
+		* @param[in] config v[̐ݒ
+		* @return void* mۂ(sNULL)
+		*/
+		void* allocate(size_t size, const buffer_pool_config& config) {
+			block b = { NULL, size, false };
+#ifdef _WIN32
+			DWORD allocType = MEM_RESERVE | MEM_COMMIT;
+			size_t allocSize = roundUp(size, config.alignment);
+			if (config.hugePages && GetLargePageMinimum() > 0) {
+				allocType |= MEM_LARGE_PAGES;
+				allocSize = roundUp(size, GetLargePageMinimum());
+			}
+
+			if (config.hugePages || config.numaLocal) {
+				UCHAR node = 0;
+				if (config.numaLocal && GetNumaProcessorNode((UCHAR)GetCurrentProcessorNumber(), &node)) {
+					b.ptr = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocSize, allocType, PAGE_READWRITE, node);
+				} else {
+					b.ptr = VirtualAlloc(NULL, allocSize, allocType, PAGE_READWRITE);
+				}
+				if (b.ptr == NULL && (allocType & MEM_LARGE_PAGES)) {
+					//SeLockMemoryPrivilegeꍇȂ
+					allocSize = roundUp(size, config.alignment);
+					b.ptr = VirtualAlloc(NULL, allocSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+				}
+				b.size = allocSize;
+				b.mapped = true;
+			} else {
+				b.ptr = _aligned_malloc(size, config.alignment);
+			}
+#else
+			if (config.hugePages) {
+				size_t allocSize = roundUp(size, (size_t)2 * 1024 * 1024);
+				void* ptr = mmap(NULL, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+				if (ptr == MAP_FAILED) {
+					//\ς݂̃q[Wy[WꍇTransparent Huge Pagev
+					ptr = mmap(NULL, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+					if (ptr != MAP_FAILED)madvise(ptr, allocSize, MADV_HUGEPAGE);
+				}
+				if (ptr != MAP_FAILED) {
+					b.ptr = ptr;
+					b.size = allocSize;
+					b.mapped = true;
+				}
+			} else if (posix_memalign(&b.ptr, config.alignment, roundUp(size, config.alignment)) != 0) {
+				b.ptr = NULL;
+			}
+
+			//first-touchɂĂяoXbhNUMAm[hɃy[Wzu
+			if (b.ptr != NULL && config.numaLocal) {
+				memset(b.ptr, 0, size);
+			}
+#endif
+			if (b.ptr == NULL)return NULL;
+			blocks.push_back(b);
+			return b.ptr;
+		}
+
+		/**
+		* mۂׂĉ
+		*/
+		void release() {
+			for (auto& b : blocks) {
+#ifdef _WIN32
+				if (b.mapped) {
+					VirtualFree(b.ptr, 0, MEM_RELEASE);
+				} else {
+					_aligned_free(b.ptr);
+				}
+#else
+				if (b.mapped) {
+					munmap(b.ptr, b.size);
+				} else {
+					free(b.ptr);
+				}
+#endif
+			}
+			blocks.clear();
+		}
+
+		~buffer_pool() {
+			release();
+		}
+	};
+
+	/**
+	* R[obNsXbhv[
+	* ̃JŋLł,J̃R[obNsɌĂ΂邱Ƃ͂Ȃ
+	*/
+	class frame_executor {
+	private:
+		std::vector<std::thread> threads;
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable cond;
+		bool running = true;
+
+		/**
+		* s[v(~͎c̏ς܂ĂI)
+		*/
+		void loop() {
+			while (true) {
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					cond.wait(lock, [this] { return !running || !tasks.empty(); });
+					if (tasks.empty())return;
+					task = std::move(tasks.front());
+					tasks.pop_front();
+				}
+				task();
+			}
+		}
+
+	public:
+		/**
+		* @param[in] threadCount Xbh
+		*/
+		explicit frame_executor(int threadCount = 1) {
+			if (threadCount < 1)threadCount = 1;
+			for (int i = 0; i < threadCount; i++) {
+				threads.emplace_back([this] { loop(); });
+			}
+		}
+
+		frame_executor(const frame_executor&) = delete;
+		frame_executor& operator=(const frame_executor&) = delete;
+
+		~frame_executor() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				running = false;
+			}
+			cond.notify_all();
+			for (auto& th : threads) {
+				//Ō̎QƂg̏̒Ŕjꂽꍇ͑҂ĂȂ
+				if (th.get_id() == std::this_thread::get_id())th.detach();
+				else if (th.joinable())th.join();
+			}
+		}
+
+		/**
+		* ̒ǉ
+		* @param[in] task 
+		*/
+		void post(std::function<void()> task) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.push_back(std::move(task));
+			}
+			cond.notify_one();
+		}
+
+		/**
+		* Xbh̎擾
+		* @return size_t Xbh
+		*/
+		inline size_t size() const {
+			return threads.size();
+		}
+	};
+
+	/**
+	* ̃JŋLϊXbhv[
+	* XbhƂ̃L[,󂢂Xbh͑̃L[̌납珈𓐂
+	* 擾Xbh͎󂯎obt@nɂȂ,ϊ̏dJ̃J҂Ȃ
+	*/
+	class convert_pool {
+	private:
+		struct worker_queue {
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		std::vector<std::thread> threads;
+		std::vector<std::unique_ptr<worker_queue>> queues;
+		std::atomic<size_t> queued{ 0 };
+		std::atomic<size_t> homes{ 0 };
+		std::atomic<unsigned long long> stolen{ 0 };
+		std::mutex sleepMutex;
+		std::condition_variable sleepCond;
+		bool running = true;
+
+		/**
+		* ̎o(̃L[͑O,̃L[͌납)
+		* @param[in] self Xbh̔ԍ
+		* @param[out] task 
+		* @return bool o
+		*/
+		bool take(size_t self, std::function<void()>& task) {
+			size_t n = queues.size();
+			for (size_t k = 0; k < n; k++) {
+				worker_queue& q = *queues[(self + k) % n];
+				std::lock_guard<std::mutex> lock(q.mutex);
+				if (q.tasks.empty())continue;
+				if (k == 0) {
+					task = std::move(q.tasks.front());
+					q.tasks.pop_front();
+				} else {
+					task = std::move(q.tasks.back());
+					q.tasks.pop_back();
+					stolen++;
+				}
+				queued--;
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		* s[v(~͎c̏ς܂ĂI)
+		* @param[in] self Xbh̔ԍ
+		*/
+		void loop(size_t self) {
+			while (true) {
+				std::function<void()> task;
+				if (take(self, task)) {
+					task();
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				sleepCond.wait(lock, [this] { return !running || queued > 0; });
+				if (!running && queued == 0)return;
+			}
+		}
+
+	public:
+		/**
+		* @param[in] threadCount Xbh(0ȂCPŨXbh)
+		* @param[in] cpus XbhŒ肷CPUԍ(iԖڂ̃Xbhcpus[i % size]ɌŒ肷.ȂŒ肵Ȃ)
+		*/
+		explicit convert_pool(int threadCount = 0, const std::vector<int>& cpus = std::vector<int>()) {
+			if (threadCount < 1)threadCount = (int)std::thread::hardware_concurrency();
+			if (threadCount < 1)threadCount = 1;
+			for (int i = 0; i < threadCount; i++) {
+				queues.emplace_back(new worker_queue());
+			}
+			for (int i = 0; i < threadCount; i++) {
+				threads.emplace_back([this, i] { loop((size_t)i); });
+				if (!cpus.empty() && !setAffinity(threads.back(), cpus[i % cpus.size()])) {
+					std::cerr << "Warning: cannot pin convert thread to CPU " << cpus[i % cpus.size()] << std::endl;
+				}
+			}
+		}
+
+		convert_pool(const convert_pool&) = delete;
+		convert_pool& operator=(const convert_pool&) = delete;
+
+		~convert_pool() {
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				running = false;
+			}
+			sleepCond.notify_all();
+			for (auto& th : threads) {
+				//Ō̎QƂg̏̒Ŕjꂽꍇ͑҂ĂȂ
+				if (th.get_id() == std::this_thread::get_id())th.detach();
+				else if (th.joinable())th.join();
+			}
+		}
+
+		/**
+		* ̒ǉ
+		* @param[in] task 
+		* @param[in] home L[̔ԍ(assignHome()̒l.J͓̏L[ɓƃLbVɏ₷)
+		*/
+		void submit(std::function<void()> task, size_t home) {
+			{
+				worker_queue& q = *queues[home % queues.size()];
+				std::lock_guard<std::mutex> lock(q.mutex);
+				q.tasks.push_back(std::move(task));
+				queued++;
+			}
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+			}
+			sleepCond.notify_one();
+		}
+
+		/**
+		* JƂ̊̃L[ԍ̊蓖(ԂɊ蓖Ă)
+		* @return size_t L[ԍ
+		*/
+		inline size_t assignHome() {
+			return homes++ % queues.size();
+		}
+
+		/**
+		* Xbh̎擾
+		* @return size_t Xbh
+		*/
+		inline size_t size() const {
+			return threads.size();
+		}
+
+		/**
+		* ̃Xbh̃L[瓐񂾏̐
+		* @return unsigned long long 񂾐
+		*/
+		inline unsigned long long getStealCount() const {
+			return stolen;
+		}
+
+		/**
+		* XbhCPUɌŒ肷
+		* @param[in] th Xbh
+		* @param[in] cpu CPUԍ
+		* @return bool Œł
+		*/
+		static bool setAffinity(std::thread& th, int cpu) {
+			if (cpu < 0)return false;
+#if defined(_WIN32)
+			if (cpu >= (int)(sizeof(DWORD_PTR) * 8))return false;
+			return SetThreadAffinityMask((HANDLE)th.native_handle(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__)
+			if (cpu >= CPU_SETSIZE)return false;
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			return pthread_setaffinity_np(th.native_handle(), sizeof(set), &set) == 0;
+#else
+			return false;
+#endif
+		}
+	};
+
+	/**
+	* ̃J֓ɏsҋ@Xbh
+	* JƂ̃Xbhϐő҂Ă,Ă΂邽тɈĂɋN
+	* (Xbh͎g񂷂,ĂԂтɃXbhԂҋ@CPȔ͂Ȃ)
+	*/
+	class trigger_gate {
+	private:
+		std::vector<std::thread> threads;
+		std::function<bool(size_t)> action;
+		std::vector<char> results;
+		std::mutex mutex;
+		std::condition_variable startCond;
+		std::condition_variable doneCond;
+		unsigned long long generation = 0;
+		size_t pending = 0;
+		bool running = true;
+
+		/**
+		* s[v
+		* @param[in] index J̔ԍ
+		*/
+		void loop(size_t index) {
+			unsigned long long seen = 0;
+			while (true) {
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					startCond.wait(lock, [&] { return !running || generation != seen; });
+					if (!running)return;
+					seen = generation;
+				}
+				bool ok = action(index);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					results[index] = ok;
+					if (--pending == 0)doneCond.notify_one();
+				}
+			}
+		}
+
+	public:
+		/**
+		* @param[in] count Xbh(J̐)
+		* @param[in] action J̔ԍ󂯎Ďs鏈
+		*/
+		trigger_gate(size_t count, std::function<bool(size_t)> action) : action(std::move(action)), results(count, 0) {
+			for (size_t i = 0; i < count; i++) {
+				threads.emplace_back([this, i] { loop(i); });
+			}
+		}
+
+		trigger_gate(const trigger_gate&) = delete;
+		trigger_gate& operator=(const trigger_gate&) = delete;
+
+		~trigger_gate() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				running = false;
+			}
+			startCond.notify_all();
+			for (auto& th : threads) {
+				if (th.joinable())th.join();
+			}
+		}
+
+		/**
+		* ׂẴXbhŏs,I܂ő҂
+		* (̃Xbh瓯ɂ͌Ă΂Ȃ)
+		* @return bool ׂẴXbhŐ
+		*/
+		bool fire() {
+			std::unique_lock<std::mutex> lock(mutex);
+			generation++;
+			pending = threads.size();
+			lock.unlock();
+			startCond.notify_all();
+			lock.lock();
+			doneCond.wait(lock, [this] { return pending == 0; });
+
+			bool ok = true;
+			for (char r : results) {
+				ok &= r != 0;
+			}
+			return ok;
+		}
+
+		/**
+		* Xbh̎擾
+		* @return size_t Xbh
+		*/
+		inline size_t size() const {
+			return threads.size();
+		}
+	};
+
 	class VideoCapture {
 	private:
 
@@ -68,9 +845,10 @@ namespace baumer {
 			/**
 			* ݒ
 			* @param[in] it VXeXgCe[^
+			* @param[in] timeout C^[tF[X̑҂[msec]
 			* @return bool ݒ肪s
 			*/
-			bool set(BGAPI2::SystemList::iterator it) {
+			bool set(BGAPI2::SystemList::iterator it, int timeout = 100) {
 				try {
 					pSystem = it->second;
 					sSystemID = it->first;
@@ -78,7 +856,7 @@ namespace baumer {
 					pSystem->Open();
 
 					interfaceList = pSystem->GetInterfaces();
-					interfaceList->Refresh(100);
+					interfaceList->Refresh(timeout);
 				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
 
 				if (sSystemID == "") {
@@ -113,7 +891,7 @@ namespace baumer {
 				return true;
 			}
 		};
-		baumer_interface_list interfaceList;
+		std::vector<baumer_interface_list> interfaceLists;
 
 		/**
 		* BaumerDevicëꗗɊւ鏈
@@ -127,16 +905,17 @@ namespace baumer {
 			/**
 			* ݒ
 			* @oaram[int] it C^[tF[XXgCe[^
+			* @param[in] timeout foCX̑҂[msec]
 			* @return ݒ肪sꂽ
 			*/
-			bool set(BGAPI2::InterfaceList::iterator it) {
+			bool set(BGAPI2::InterfaceList::iterator it, int timeout = 100) {
 				try {
 					pInterface = it->second;
 					sInterfaceID = it->first;
 					pInterface->Open();
 
 					deviceList = pInterface->GetDevices();
-					deviceList->Refresh(100);
+					deviceList->Refresh(timeout);
 
 					if (deviceList->size() > 0) {
 						sInterfaceID = it->first;
@@ -174,7 +953,7 @@ namespace baumer {
 				return true;
 			}
 		};
-		baumer_device_list deviceList;
+		std::vector<baumer_device_list> deviceLists;
 
 
 	public:
@@ -192,68 +971,393 @@ namespace baumer {
 			bo_double fExposureTimeMin = 0;
 			bo_double fExposureTimeMax = 0;
 			BGAPI2::String sExposureNodeName = "";
+			std::string sFirmwareVersion;
+			bool fromCache = false;
 
 			bo_double fGainMin = 0;
 			bo_double fGainMax = 0;
 			bool capturing = false;
 
+			bo_double fExposureTime = 0;
+			bo_double fGain = 0;
+			bool hasExposureTime = false;
+			bool hasGain = false;
+
 			/**
-			* f[^Xg[̏܂Ƃ߂NX
+			* m[h̃nhƒl,͈͂̃LbV
+			* ̖OƃJւ̖₢킹
 			*/
-			struct beumer_data_stream {
-				BGAPI2::DataStreamList *datastreamList = NULL;
-				BGAPI2::DataStream * pDataStream = NULL;
-				BGAPI2::String sDataStreamID;
-
-				BGAPI2::BufferList *bufferList = NULL;
-				BGAPI2::Buffer * pBuffer = NULL;
-				BGAPI2::String sBufferID;
-				BGAPI2::Buffer * pBufferFilled = NULL;
-				bool streaming = false;
+			struct int_node {
+				BGAPI2::Node* node = NULL;
+				bo_int64 value = 0;
+				bo_int64 iMin = 0;
+				bo_int64 iMax = 0;
+				bo_int64 iInc = 1;
+				bool hasValue = false;
+				bool hasRange = false;
 
 				/**
-				* ݒ
+				* m[h̉
 				* @param[in] dev foCX
-				* @return bool ݒ肪sꂽ
+				* @param[in] name m[h
 				*/
-				bool set(BGAPI2::Device* dev) {
-					datastreamList = dev->GetDataStreams();
-					datastreamList->Refresh();
+				void bind(BGAPI2::Device* dev, const char* name) {
+					node = dev->GetRemoteNodeList()->GetNodePresent(name) ? dev->GetRemoteNode(name) : NULL;
+					invalidate();
+				}
 
-					for (auto dstIterator = datastreamList->begin(); dstIterator != datastreamList->end(); dstIterator++) {
-						try {
-							dstIterator->second->Open();
-							sDataStreamID = dstIterator->first;
-							break;
-						} catch (BGAPI2::Exceptions::IException& ex) {}
+				/**
+				* LbV̔j
+				*/
+				inline void invalidate() {
+					hasValue = false;
+					hasRange = false;
+				}
+
+				/**
+				* l̎擾
+				* @param[in] defaultValue m[hꍇ̒l
+				* @return bo_int64 l
+				*/
+				inline bo_int64 get(bo_int64 defaultValue) {
+					if (node == NULL)return defaultValue;
+					if (!hasValue) {
+						value = node->GetInt();
+						hasValue = true;
 					}
+					return value;
+				}
 
-					if (sDataStreamID == "") {
-						return false;
-					} else {
-						pDataStream = (*datastreamList)[sDataStreamID];
+				/**
+				* l̐ݒ(݂ɍ킹Ĕ͈͓Ɋۂ߂)
+				* @param[in] v ݒl
+				* @return bool ݒł
+				*/
+				bool set(bo_int64 v) {
+					if (node == NULL || !node->IsWriteable())return false;
+					if (!hasRange) {
+						iMin = node->GetIntMin();
+						iMax = node->GetIntMax();
+						iInc = node->GetIntInc();
+						hasRange = true;
 					}
 
+					if (iInc > 0)v = (v / iInc) * iInc;
+					if (v < iMin) { v = iMin; }
+					if (v > iMax) { v = iMax; }
+
+					node->SetInt(v);
+					value = v;
+					hasValue = true;
 					return true;
 				}
 
 				/**
-				* f[^]Jn
-				* @return bool
-				* f[^]Jnł
+				* ݏ߂邩
+				* @return bool ߂邩
+				*/
+				inline bool isWriteable() {
+					return node != NULL && node->IsWriteable();
+				}
+			};
+
+			int_node nWidth;
+			int_node nHeight;
+			int_node nOffsetX;
+			int_node nOffsetY;
+			int_node nBinningHorizontal;
+			int_node nBinningVertical;
+			int_node nDecimationHorizontal;
+			int_node nDecimationVertical;
+
+			BGAPI2::Node* pAcquisitionStart = NULL;
+			BGAPI2::Node* pAcquisitionStop = NULL;
+			BGAPI2::Node* pAcquisitionAbort = NULL;
+			BGAPI2::Node* pTriggerMode = NULL;
+			BGAPI2::Node* pTriggerSelector = NULL;
+			BGAPI2::Node* pTriggerSource = NULL;
+			BGAPI2::Node* pTriggerActivation = NULL;
+			BGAPI2::Node* pTriggerSoftware = NULL;
+			BGAPI2::Node* pBurstFrameCount = NULL;
+
+			bool bTriggerMode = false;
+			BGAPI2::String sTriggerSelector = "FrameStart";
+			BGAPI2::String sTriggerSource;		//Ȃ疢ݒ(J̒l̂܂)
+			BGAPI2::String sTriggerActivation;	//Ȃ疢ݒ(J̒l̂܂)
+			int burstCount = 1;
+			bool burstEmulated = false;			//Jo[XgɑΉĂȂꍇ̓gKJԂ
+			BGAPI2::Node* pPixelFormat = NULL;
+
+			/**
+			* BGAPI2̃obt@cv::Mat̎ɌѕtAP[^
+			* Ōcv::Matꂽ_Ńobt@hCo֍ăL[
+			*/
+			struct buffer_allocator : public cv::MatAllocator, public std::enable_shared_from_this<buffer_allocator> {
+				/**
+				* cv::Matɕ񂾃obt@(UMatData::userdataɓ)
+				* AP[^̎QƂ,AP[^cv::MatɔjȂ
+				*/
+				struct wrapped_buffer {
+					BGAPI2::Buffer* buffer;
+					std::shared_ptr<const buffer_allocator> owner;
+				};
+
+				mutable std::atomic<int> held{ 0 };
+				std::atomic<bool> alive{ true };
+				mutable std::mutex mutex;
+				mutable std::set<BGAPI2::Buffer*> wrapped;	//cv::Matɕ܂Ăobt@(mutexŕی)
+				mutable std::set<BGAPI2::Buffer*> orphaned;	//o^܂ꂽ܂܂̃obt@(ɔj)
+				mutable std::vector<std::shared_ptr<buffer_pool>> retained;	//orphaned̃(SĔj)
+
+				/**
+				* VKmۂ͍sȂ(obt@̓hCoL)
+				*/
+				cv::UMatData* allocate(int, const int*, int, void*, size_t*, cv::AccessFlag, cv::UMatUsageFlags) const override {
+					return NULL;
+				}
+
+				/**
+				* VKmۂ͍sȂ(obt@̓hCoL)
+				*/
+				bool allocate(cv::UMatData*, cv::AccessFlag, cv::UMatUsageFlags) const override {
+					return false;
+				}
+
+				/**
+				* Ō̎QƂOꂽobt@ăL[
+				* @param[in] u f[^
+				*/
+				void deallocate(cv::UMatData* u) const override {
+					if (u == NULL)return;
+					//Ōcv::MatȂAP[^Ŕj
+					std::shared_ptr<const buffer_allocator> keep;
+					wrapped_buffer* w = (wrapped_buffer*)u->userdata;
+					if (w != NULL) {
+						keep = w->owner;
+						reclaim(w->buffer);
+						delete w;
+					}
+					held--;
+					delete u;
+				}
+
+				/**
+				* ܂Ăobt@Ԃ
+				* (Jn̍ăL[ƏdȂȂ悤,mutex܂܍ăL[)
+				* @param[in] buffer obt@
+				*/
+				void reclaim(BGAPI2::Buffer* buffer) const {
+					std::vector<std::shared_ptr<buffer_pool>> pools;	//Ō̓o^ς݂̃obt@Ȃ烁ŉ
+					std::lock_guard<std::mutex> lock(mutex);
+					wrapped.erase(buffer);
+					if (orphaned.erase(buffer) > 0) {
+						delete buffer;
+						if (orphaned.empty())pools.swap(retained);
+						return;
+					}
+					if (!alive)return;
+					try {
+						buffer->QueueBuffer();
+					} catch (BGAPI2::Exceptions::IException& ex) {}
+				}
+
+				/**
+				* Jn̍ăL[(cv::Matɕ܂Ăobt@͉ɍăL[邽ߏ)
+				* @param[in] buffer obt@
+				*/
+				void queueIdle(BGAPI2::Buffer* buffer) const {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (wrapped.count(buffer) == 0 && !buffer->GetIsQueued())buffer->QueueBuffer();
+				}
+
+				/**
+				* obt@̓o^
+				* cv::Matɕ܂Ăobt@͍Ōcv::MatꂽƂɔj,ȊO͂ɔj
+				* @param[in] list obt@̈ꗗ
+				* @param[in] buffer obt@
+				*/
+				void revoke(BGAPI2::BufferList* list, BGAPI2::Buffer* buffer) {
+					std::lock_guard<std::mutex> lock(mutex);
+					list->RevokeBuffer(buffer);
+					if (wrapped.count(buffer) > 0) {
+						orphaned.insert(buffer);
+					} else {
+						delete buffer;
+					}
+				}
+
+				/**
+				* o^obt@cĂ΃a
+				* @param[in] pool obt@̃
+				* @return bool a(falseȂĂяołɉ)
+				*/
+				bool retain(const std::shared_ptr<buffer_pool>& pool) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (orphaned.empty())return false;
+					retained.push_back(pool);
+					return true;
+				}
+
+				/**
+				* QƂcĂȂΉ
+				* @param[in] u f[^
+				*/
+				void unmap(cv::UMatData* u) const override {
+					if (u->urefcount == 0 && u->refcount == 0) {
+						deallocate(u);
+					}
+				}
+
+				/**
+				* obt@Rs[cv::MatƂĕ
+				* @param[in] buffer 擾ς݂̃obt@
+				* @param[in] type cv::Mať^
+				* @param[out] mat 摜o(Ƀobt@ăL[)
+				*/
+				void wrap(BGAPI2::Buffer* buffer, int type, cv::Mat& mat) const {
+					cv::Mat tmp((int)buffer->GetHeight(), (int)buffer->GetWidth(), type, (char *)((bo_uint64)(buffer->GetMemPtr()) + buffer->GetImageOffset()));
+
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						wrapped.insert(buffer);
+					}
+					cv::UMatData* u = new cv::UMatData(this);
+					u->data = u->origdata = tmp.data;
+					u->size = tmp.total() * tmp.elemSize();
+					u->flags |= cv::UMatData::USER_ALLOCATED;
+					u->userdata = new wrapped_buffer{ buffer, shared_from_this() };
+					u->refcount = 1;
+
+					tmp.u = u;
+					tmp.allocator = (cv::MatAllocator*)this;
+					held++;
+					mat = tmp;
+				}
+			};
+
+			/**
+			* f[^Xg[̏܂Ƃ߂NX
+			*/
+			struct beumer_data_stream {
+				BGAPI2::DataStreamList *datastreamList = NULL;
+				BGAPI2::DataStream * pDataStream = NULL;
+				BGAPI2::String sDataStreamID;
+
+				BGAPI2::BufferList *bufferList = NULL;
+				BGAPI2::Buffer * pBuffer = NULL;
+				BGAPI2::String sBufferID;
+				BGAPI2::Buffer * pBufferFilled = NULL;
+				bool streaming = false;
+
+				BGAPI2::Device* pDevice = NULL;
+				BGAPI2::Node* pPixelFormat = NULL;
+				BGAPI2::Node* pPayloadSize = NULL;
+				BGAPI2::Node* pLostFrameCount = NULL;
+				buffer_pool_config poolConfig;
+				std::shared_ptr<buffer_pool> pool;
+				bool zeroCopy = false;
+				int maxHeldBuffers = 3;
+				std::shared_ptr<buffer_allocator> allocator;
+				std::shared_ptr<raw_recorder> recorder;
+				std::shared_ptr<auto_exposure> exposure;	//Io(Rs[ԂŋL)
+
+				frame_info info;
+				bool profiling = false;
+				read_timing timing;
+				std::shared_ptr<device_counters> counters;
+
+				int timeoutMs = 1000;			//GetFilledBuffeȓ҂(K͏)[msec]
+				bool adaptiveTimeout = false;	//󂯎Ԋu҂Ԃ߂邩
+				double timeoutFactor = 3.0;		//K̑҂Ԃ̎󂯎Ԋuɑ΂{
+				int minTimeoutMs = 5;			//K̑҂Ԃ̉[msec]
+				double frameInterval = 0;		//󂯎Ԋüړ[nsec]
+				bo_uint64 lastHostTimestamp = 0;
+
+				pixel_format format = pixel_format::Unknown;
+				converter convert = getConverter(pixel_format::Unknown);
+				char formatName[32] = {};
+				bool nativeBitDepth = false;
+				convert_options convertOptions;
+				int pyramidLevels = 0;			//ϊƍ킹čk摜̒i
+
+				/**
+				* ݒ
+				* @param[in] dev foCX
+				* @return bool ݒ肪sꂽ
+				*/
+				bool set(BGAPI2::Device* dev) {
+					pDevice = dev;
+					try {
+						pPixelFormat = dev->GetRemoteNode("PixelFormat");
+						pPayloadSize = dev->GetRemoteNodeList()->GetNodePresent("PayloadSize") ? dev->GetRemoteNode("PayloadSize") : NULL;
+					} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+
+					datastreamList = dev->GetDataStreams();
+					datastreamList->Refresh();
+
+					for (auto dstIterator = datastreamList->begin(); dstIterator != datastreamList->end(); dstIterator++) {
+						try {
+							dstIterator->second->Open();
+							sDataStreamID = dstIterator->first;
+							break;
+						} catch (BGAPI2::Exceptions::IException& ex) {}
+					}
+
+					if (sDataStreamID == "") {
+						return false;
+					} else {
+						pDataStream = (*datastreamList)[sDataStreamID];
+					}
+
+					try {
+						BGAPI2::NodeMap* nodes = pDataStream->GetNodeList();
+						pLostFrameCount = nodes->GetNodePresent("StreamLostFrameCount") ? nodes->GetNode("StreamLostFrameCount") : NULL;
+					} catch (BGAPI2::Exceptions::IException& ex) {}
+
+					allocator = std::make_shared<buffer_allocator>();
+					pool = std::make_shared<buffer_pool>();
+					counters = std::make_shared<device_counters>();
+					exposure = std::make_shared<auto_exposure>();
+					return true;
+				}
+
+				/**
+				* ʂ̃f[^Xg[̓ǂݍݐݒ̈p(Đڑp)
+				* v͋L,obt@ƕϊ͎̊Jnɍ蒼
+				* @param[in] other pf[^Xg[
+				*/
+				void inherit(const beumer_data_stream& other) {
+					poolConfig = other.poolConfig;
+					zeroCopy = other.zeroCopy;
+					maxHeldBuffers = other.maxHeldBuffers;
+					profiling = other.profiling;
+					counters = other.counters;
+					timeoutMs = other.timeoutMs;
+					adaptiveTimeout = other.adaptiveTimeout;
+					timeoutFactor = other.timeoutFactor;
+					minTimeoutMs = other.minTimeoutMs;
+					nativeBitDepth = other.nativeBitDepth;
+					convertOptions = other.convertOptions;
+					pyramidLevels = other.pyramidLevels;
+				}
+
+				/**
+				* f[^]Jn
+				* @return bool
+				* f[^]Jnł
 				*/
 				bool startStream() {
 					if (streaming)return true;
+					resolveFormat();
+					lastHostTimestamp = 0;
 					bufferList = pDataStream->GetBufferList();
 
 					try {
-						for (int i = 0; i<4; i++) {
-							pBuffer = new BGAPI2::Buffer();
-							bufferList->Add(pBuffer);
-						}
+						//obt@stopStreamŔj,̊Jnɍėp
+						if (bufferList->size() == 0 && !allocateBuffers())return false;
 						for (BGAPI2::BufferList::iterator bufIterator = bufferList->begin(); bufIterator != bufferList->end(); bufIterator++) {
-							bufIterator->second->QueueBuffer();
-						} 
+							allocator->queueIdle(bufIterator->second);
+						}
 					} catch (BGAPI2::Exceptions::IException& ex) { return false; }
 
 					try {
@@ -264,6 +1368,82 @@ namespace baumer {
 					return true;
 				}
 
+				/**
+				* sNZtH[}bg̉
+				* 摜ƂɕrȂ悤,ϊ֐ňx߂
+				* @return bool ΉĂtH[}bg
+				*/
+				bool resolveFormat() {
+					try {
+						BGAPI2::String name = pPixelFormat->GetString();
+						memset(formatName, 0, sizeof(formatName));
+						strncpy(formatName, name.get(), sizeof(formatName) - 1);
+					} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+
+					format = toPixelFormat(formatName);
+					convert = getConverter(format, nativeBitDepth, convertOptions);
+					return format != pixel_format::Unknown;
+				}
+
+				/**
+				* obt@v[̊m
+				* @return bool ݒ肵̃obt@mۂł
+				*/
+				bool allocateBuffers() {
+					bo_uint64 payloadSize = 0;
+					if (poolConfig.userMemory || poolConfig.hugePages || poolConfig.numaLocal) {
+						if (pDataStream->GetDefinesPayloadSize()) {
+							payloadSize = pDataStream->GetPayloadSize();
+						} else {
+							payloadSize = pPayloadSize->GetInt();
+						}
+					}
+
+					for (int i = 0; i < poolConfig.count; i++) {
+						if (payloadSize > 0) {
+							void* mem = pool->allocate((size_t)payloadSize, poolConfig);
+							if (mem == NULL)return false;
+							pBuffer = new BGAPI2::Buffer(mem, payloadSize, NULL);
+						} else {
+							pBuffer = new BGAPI2::Buffer();
+						}
+						bufferList->Add(pBuffer);
+					}
+					return true;
+				}
+
+				/**
+				* obt@v[̔j
+				* startStreamŌ݂̐ݒɏ]čĊmۂ
+				* @return bool jł
+				*/
+				bool releaseBuffers() {
+					if (streaming)return false;
+					if (recorder)recorder->flush();
+					try {
+						bufferList = pDataStream->GetBufferList();
+						revokeBuffers();
+					} catch (BGAPI2::Exceptions::IException& ex) {
+						return false;
+					}
+					return true;
+				}
+
+				/**
+				* obt@̓o^Ɣj
+				* [Rs[ŃAvP[VĂ摜̃obt@ƃ,Ōcv::Mat܂Ŏc
+				*/
+				void revokeBuffers() {
+					while (bufferList && bufferList->size() > 0) {
+						allocator->revoke(bufferList, bufferList->begin()->second);
+					}
+					if (allocator->retain(pool)) {
+						pool = std::make_shared<buffer_pool>();
+					} else {
+						pool->release();
+					}
+				}
+
 				/**
 				* f[^]I
 				* @return bool f[^]Ił
@@ -272,6 +1452,8 @@ namespace baumer {
 					if (!streaming)return false;
 					try {
 						pDataStream->StopAcquisition();
+						//L^҂̃obt@߂Ă̂Ă(̊JnœdɍăL[Ȃ)
+						if (recorder)recorder->flush();
 						bufferList->DiscardAllBuffers();
 					} catch (BGAPI2::Exceptions::IException& ex) { return false; }
 
@@ -279,83 +1461,283 @@ namespace baumer {
 					return true;
 				}
 
+				/**
+				* ݂̑҂
+				* K͎󂯎Ԋu̐{ɂ邽,~܂J𒷂҂Ȃ
+				* @return int ҂[msec]
+				*/
+				inline int currentTimeout() const {
+					if (!adaptiveTimeout || frameInterval <= 0)return timeoutMs;
+					int timeout = (int)(frameInterval * timeoutFactor * 1e-6) + 1;
+					return std::max(minTimeoutMs, std::min(timeoutMs, timeout));
+				}
+
 				/**
 				* 摜̓ǂݍ
 				* @param[out] mat 摜o
 				* @param bool 摜ǂݍ߂
 				*/
 				bool read(cv::Mat& mat) {
+					return read(mat, currentTimeout());
+				}
+
+				/**
+				* ҂Ԃw肵摜̓ǂݍ
+				* @param[out] mat 摜o
+				* @param[in] timeout ҂[msec](0Ȃ҂,^CAEgƂĐȂ)
+				* @return bool 摜ǂݍ߂
+				*/
+				bool read(cv::Mat& mat, int timeout, std::vector<cv::Mat>* pyramid = NULL) {
+					if (zeroCopy && allocator->held >= maxHeldBuffers) {
+						std::cerr << "Error: Too many buffers held by application" << std::endl;
+						return false;
+					}
+
+					stage_timer timer(profiling);
+					BGAPI2::Buffer* buffer = fetch(timeout, timer);
+					if (buffer == NULL)return false;
+					return convertBuffer(buffer, info, mat, timer, timing, pyramid);
+				}
+
+				/**
+				* obt@̎󂯎
+				* @param[in] timeout ҂[msec](0Ȃ҂,^CAEgƂĐȂ)
+				* @param[in,out] timer ԂƂ̎Ԍv
+				* @return BGAPI2::Buffer* 󂯎obt@(^f[^infoɓ.^CAEgsSȉ摜ȂNULL)
+				*/
+				BGAPI2::Buffer* fetch(int timeout, stage_timer& timer) {
+					BGAPI2::Buffer* buffer = receive(timeout, timer);
+					if (buffer == NULL)return NULL;
+					return accept(buffer) ? buffer : NULL;
+				}
+
+				/**
+				* obt@҂̎󂯎(accept͌Ăяoōs)
+				* @param[in] timeout ҂[msec](0Ȃ҂,^CAEgƂĐȂ)
+				* @param[in,out] timer ԂƂ̎Ԍv
+				* @return BGAPI2::Buffer* 󂯎obt@(^CAEgȂNULL)
+				*/
+				BGAPI2::Buffer* receive(int timeout, stage_timer& timer) {
 					try {
-						pBufferFilled = pDataStream->GetFilledBuffer(1000); //timeout 1000 msec
+						pBufferFilled = pDataStream->GetFilledBuffer((bo_uint64)timeout);
+						timer.lap(timing.wait);
 						if (pBufferFilled == NULL) {
-							std::cerr << "Error: Buffer Timeout after 1000 msec" << std::endl;
-							return false;
-						} else if (pBufferFilled->GetIsIncomplete()) {
+							if (timeout > 0) {
+								device_counters::add(counters->timeouts);
+								std::cerr << "Error: Buffer Timeout after " << timeout << " msec" << std::endl;
+							}
+							return NULL;
+						}
+					} catch (BGAPI2::Exceptions::IException& ex) {
+						device_counters::add(counters->errors);
+						return NULL;
+					}
+					return pBufferFilled;
+				}
+
+				/**
+				* 󂯎obt@̕ϊ
+				* (|[OƃCxg쓮̗g)
+				* @param[in] buffer 󂯎obt@([Rs[ȊO͕ϊɍăL[)
+				* @param[out] mat 摜o
+				* @param[in,out] timer ԂƂ̎Ԍv
+				* @return bool 摜ǂݍ߂
+				*/
+				bool deliver(BGAPI2::Buffer* buffer, cv::Mat& mat, stage_timer& timer) {
+					return accept(buffer) && convertBuffer(buffer, info, mat, timer, timing);
+				}
+
+				/**
+				* 󂯎obt@̃^f[^̎擾
+				* sSȉ摜͂ōăL[(L^ȂL^)
+				* @param[in] buffer 󂯎obt@
+				* @return bool ϊɐi߂邩
+				*/
+				bool accept(BGAPI2::Buffer* buffer) {
+					bool recorded = false;	//L^֓n(nobt@͋L^ōăL[)
+					try {
+						info.timestamp = buffer->GetTimestamp();
+						info.frameID = buffer->GetFrameID();
+						info.hostTimestamp = steadyNow();
+						if (lastHostTimestamp != 0) {
+							double interval = (double)(info.hostTimestamp - lastHostTimestamp);
+							frameInterval = frameInterval <= 0 ? interval : frameInterval + (interval - frameInterval) / 8;
+						}
+						lastHostTimestamp = info.hostTimestamp;
+						info.width = (int)buffer->GetWidth();
+						info.height = (int)buffer->GetHeight();
+						info.offsetX = (int)buffer->GetXOffset();
+						info.offsetY = (int)buffer->GetYOffset();
+						info.incomplete = buffer->GetIsIncomplete();
+						//Đ̍i荞݂Ɏg,obt@g̃tH[}bgc(Ȃΐݒl)
+						const char* bufferFormat = formatName;
+						BGAPI2::String name;
+						try {
+							name = buffer->GetPixelFormat();
+							if (name.get() != NULL && name.get()[0] != 0)bufferFormat = name.get();
+						} catch (BGAPI2::Exceptions::IException& ex) {}
+						memset(info.pixelFormat, 0, sizeof(info.pixelFormat));
+						strncpy(info.pixelFormat, bufferFormat, sizeof(info.pixelFormat) - 1);
+						counters->checkFrameID(info.frameID);
+						if (info.incomplete) {
+							device_counters::add(counters->incomplete);
 							std::cerr << "Error: Image is incomplete" << std::endl;
 							// queue buffer again
-							pBufferFilled->QueueBuffer();
+							recorded = record(buffer, info);
+							if (!recorded)buffer->QueueBuffer();
+							return false;
+						}
+					} catch (BGAPI2::Exceptions::IException& ex) {
+						device_counters::add(counters->errors);
+						if (!recorded)requeueFailed(buffer);
+						return false;
+					}
+					return true;
+				}
+
+				/**
+				* ̓rŎsobt@̍ăL[
+				* (cv::Matɕ܂ꂽobt@ăL[ς݂̃obt@͂̂܂)
+				* @param[in] buffer 󂯎obt@
+				*/
+				void requeueFailed(BGAPI2::Buffer* buffer) {
+					try {
+						if (allocator) {
+							allocator->queueIdle(buffer);
+						} else if (!buffer->GetIsQueued()) {
+							buffer->QueueBuffer();
+						}
+					} catch (BGAPI2::Exceptions::IException& ex) {}
+				}
+
+				/**
+				* obt@̕ϊƍăL[
+				* ϊ̐ݒǂނȂ̂,ϊv[̃̕Xbh瓯ɌĂׂ
+				* @param[in] buffer acceptʂobt@
+				* @param[in] frameInfo obt@̃^f[^
+				* @param[out] mat 摜o
+				* @param[in,out] timer ԂƂ̎Ԍv
+				* @param[out] t ԂƂ̏v
+				* @param[out] pyramid k摜̏o(NULL܂pyramidLevels0ȂȂ)
+				* @param[out] recordLater NULLłȂ,L^̓obt@L^֓ntrue
+				*                         (Ăяo󂯎handBackĂ. ϊv[ŋL^̏Ԃۂ)
+				* @return bool 摜ǂݍ߂
+				*/
+				bool convertBuffer(BGAPI2::Buffer* buffer, const frame_info& frameInfo, cv::Mat& mat, stage_timer& timer, read_timing& t, std::vector<cv::Mat>* pyramid = NULL, bool* recordLater = NULL) {
+					bool requeue = true;	//falseȂcv::MatL^ăL[
+					try {
+						raw_frame raw;
+						raw.data = (char *)((bo_uint64)(buffer->GetMemPtr()) + buffer->GetImageOffset());
+						raw.width = frameInfo.width;
+						raw.height = frameInfo.height;
+						raw.format = format;
+						//Io̓v͕ϊVtg̑Õobt@
+						if (exposure->isEnabled())exposure->update(raw, frameInfo.hostTimestamp);
+						timer.lap(t.exposure);
+						int directType = getDirectType(format, convertOptions);
+						if (zeroCopy && directType >= 0 && !recorder) {//zero copy: the buffer is queued again when mat is released
+							allocator->wrap(buffer, directType, mat);
+							timer.lap(t.dispatch);
+							t.convert = 0;
+							int shift = nativeBitDepth ? 0 : getBitShift(format);
+							if (shift > 0)shiftLeft16(mat.ptr<ushort>(), mat.ptr<ushort>(), mat.total(), shift); //the buffer is owned by mat
+							timer.lap(t.shift);
+							requeue = false;
 						} else {
-							if ((pBufferFilled->GetPixelFormat() == "BGR8") || (pBufferFilled->GetPixelFormat() == "BGR8Packed")) {//BGR8 is openCV default format
-								cv::Mat *tmp = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_8UC3, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								mat = *tmp;
-
-							} else if ((pBufferFilled->GetPixelFormat() == "BayerRG8") || (pBufferFilled->GetPixelFormat() == "BayerGB8")) {//need conversion to BGR8 is openCV default format
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_8UC1, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								cv::Mat* imTransformBGR8 = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_8UC3); //memory allocation
-
-								if (pBufferFilled->GetPixelFormat() == "BayerRG8") {
-									cv::cvtColor(*imOriginal, *imTransformBGR8, cv::COLOR_BayerBG2BGR); //to BGR
-								} else if (pBufferFilled->GetPixelFormat() == "BayerGB8") {
-									cv::cvtColor(*imOriginal, *imTransformBGR8, cv::COLOR_BayerGR2BGR); //to BGR
-								}
-
-								//release opencv images
-								delete imOriginal;                     //release opencv image
-
-								mat = *imTransformBGR8;
-
-
-							} else if ((pBufferFilled->GetPixelFormat() == "Mono8") || (pBufferFilled->GetPixelFormat() == "BayerRG8") || (pBufferFilled->GetPixelFormat() == "BayerGB8")) {//openCV format (CV_8UC1)
-								cv::Mat* tmp = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_8UC1, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								mat = *tmp;
-							} else if (pBufferFilled->GetPixelFormat() == "Mono16") {
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC1, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								mat = *imOriginal;
-							} else if ((pBufferFilled->GetPixelFormat() == "Mono12") || (pBufferFilled->GetPixelFormat() == "BayerRG12") || (pBufferFilled->GetPixelFormat() == "BayerGB12")) {
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC1, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								*imOriginal *= 16; //shift 4 bits
-								mat = *imOriginal;
-							} else if ((pBufferFilled->GetPixelFormat() == "Mono10") || (pBufferFilled->GetPixelFormat() == "BayerRG10") || (pBufferFilled->GetPixelFormat() == "BayerGB10")) { //openCV format (CV_16UC1)
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC1, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								*imOriginal *= 64; //shift 6 bits
-								mat = *imOriginal;
-							} else if (pBufferFilled->GetPixelFormat() == "BGR16") {
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC3, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								cv::Mat* imConvert = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC3); //memory allocation
-								imOriginal->convertTo(*imConvert, CV_16UC3, 1.0); //full copy with previous memory allocation AND scaling of 1.0
-								mat = *imConvert;
-							} else if (pBufferFilled->GetPixelFormat() == "BGR12") {
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC3, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								cv::Mat* imConvert = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC3); //memory allocation
-								imOriginal->convertTo(*imConvert, CV_16UC3, 16.0); //full copy with previous memory allocation AND scaling of 16.0 to convert 12-Bit to 16-Bit 
-								mat = *imConvert;
-							} else if (pBufferFilled->GetPixelFormat() == "BGR10") {
-								cv::Mat* imOriginal = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC3, (char *)((bo_uint64)(pBufferFilled->GetMemPtr()) + pBufferFilled->GetImageOffset()));
-								cv::Mat* imConvert = new cv::Mat((int)pBufferFilled->GetHeight(), (int)pBufferFilled->GetWidth(), CV_16UC3); //memory allocation
-								imOriginal->convertTo(*imConvert, CV_16UC3, 64.0); //full copy with previous memory allocation AND scaling of 64.0 to convert 10-Bit to 16-Bit 
-								mat = *imConvert;
-							}
-							// queue buffer again
-							pBufferFilled->QueueBuffer();
+							timer.lap(t.dispatch);
+							convert(raw, mat, convertOptions);
+							timer.lap(t.convert);
+							t.shift = 0;
 						}
-					} catch (BGAPI2::Exceptions::IException& ex) { return false; }
-					catch (std::exception& e) { return false; }
+						//k摜̓obt@ăL[OɃZT̉摜
+						if (pyramid != NULL && pyramidLevels > 0) {
+							buildPyramid(raw, mat, *pyramid, pyramidLevels, convertOptions, nativeBitDepth);
+							timer.lap(t.pyramid);
+						} else {
+							t.pyramid = 0;
+						}
+						// queue buffer again (recorded buffers are queued by the recorder after writing)
+						if (requeue && recordLater != NULL && recorder) {
+							*recordLater = true;
+							requeue = false;
+						} else if (requeue) {
+							requeue = !record(buffer, frameInfo);
+							if (requeue)buffer->QueueBuffer();
+						}
+						timer.lap(t.requeue);
+					} catch (BGAPI2::Exceptions::IException& ex) {
+						device_counters::add(counters->errors);
+						if (requeue)requeueFailed(buffer);
+						return false;
+					} catch (std::exception& e) {
+						device_counters::add(counters->errors);
+						if (requeue)requeueFailed(buffer);
+						return false;
+					}
 
 					if (mat.empty())return false;
-					pBufferFilled = NULL;
+					device_counters::add(counters->delivered);
+					counters->convert.record(steadyNow() - frameInfo.hostTimestamp);
 					return true;
 				}
 
+				/**
+				* ϊIobt@L^֓năL[(convertBufferrecordLaterp)
+				* @param[in] buffer ϊIobt@
+				* @param[in] frameInfo obt@̃^f[^
+				*/
+				void handBack(BGAPI2::Buffer* buffer, const frame_info& frameInfo) {
+					try {
+						if (!record(buffer, frameInfo))buffer->QueueBuffer();
+					} catch (BGAPI2::Exceptions::IException& ex) {
+						device_counters::add(counters->errors);
+						requeueFailed(buffer);
+					}
+				}
+
+				/**
+				* L^Ȃ󂯎obt@ݑ҂ɂ
+				* (ϊςłĂ.݌ɋL^̃XbhōăL[)
+				* @param[in] buffer 󂯎obt@
+				* @param[in] frameInfo obt@̃^f[^
+				* @return bool ݑ҂ɂ(falseȂĂяoōăL[)
+				*/
+				bool record(BGAPI2::Buffer* buffer, const frame_info& frameInfo) {
+					if (!recorder)return false;
+					raw_record_header header = {};
+					header.payloadSize = buffer->GetImageLength();
+					header.timestamp = frameInfo.timestamp;
+					header.frameID = frameInfo.frameID;
+					header.hostTimestamp = frameInfo.hostTimestamp;
+					header.width = frameInfo.width;
+					header.height = frameInfo.height;
+					header.offsetX = frameInfo.offsetX;
+					header.offsetY = frameInfo.offsetY;
+					header.flags = frameInfo.incomplete ? RAW_RECORD_INCOMPLETE : 0;
+					memcpy(header.pixelFormat, frameInfo.pixelFormat, sizeof(header.pixelFormat));
+					const char* data = (const char*)buffer->GetMemPtr() + buffer->GetImageOffset();
+					return recorder->push(data, header, [buffer] {
+						try {
+							buffer->QueueBuffer();
+						} catch (BGAPI2::Exceptions::IException& ex) {}
+					});
+				}
+
+				/**
+				* hCov̎擾
+				* @param[out] stats o͐(driver*̍ڂ̂ݍXV)
+				*/
+				void getDriverStats(device_stats& stats) {
+					try {
+						BGAPI2::BufferList* buffers = pDataStream->GetBufferList();
+						stats.driverDelivered = buffers->GetDeliveredCount();
+						stats.driverUnderrun = buffers->GetUnderrunCount();
+						stats.driverQueued = buffers->GetQueuedCount();
+						stats.driverAwaitDelivery = buffers->GetAwaitDelivery();
+						if (pLostFrameCount != NULL)stats.driverLost = (uint64_t)pLostFrameCount->GetInt();
+					} catch (BGAPI2::Exceptions::IException& ex) {}
+				}
+
 				/**
 				* I
 				* @return bool Ił
@@ -369,13 +1751,11 @@ namespace baumer {
 				* @return bool Jł
 				*/
 				bool release() {
+					if (!allocator)return true;
+					allocator->alive = false;
+					if (recorder)recorder->flush();
 					try {
-						while (bufferList && bufferList->size() > 0) {
-							pBuffer = bufferList->begin()->second;
-							bufferList->RevokeBuffer(pBuffer);
-							delete pBuffer;
-						}
-
+						revokeBuffers();
 						pDataStream->Close();
 					} catch (BGAPI2::Exceptions::IException& ex) {
 						return false;
@@ -388,143 +1768,1554 @@ namespace baumer {
 
 		public:
 			/**
-			* ݒ
-			* @param[in] it foCXXgCe[^
-			* @return ݒł
+			* ^CX^vt̉摜
 			*/
-			bool set(BGAPI2::DeviceList::iterator it) {
-				try{
-					it->second->Open();
-					pDevice = it->second;
-					sDeviceID = it->first;
-				} catch (BGAPI2::Exceptions::ResourceInUseException& ex) {
-					return false;
-				} catch (BGAPI2::Exceptions::AccessDeniedException& ex) {
-					return false;
+			struct grabbed_frame {
+				cv::Mat mat;
+				frame_info info;
+				std::vector<cv::Mat> pyramid;	//k摜(setPyramid()Œiw肵Ƃ. pyramid[0]matƓ摜)
+			};
+
+		private:
+
+			/**
+			* JƂ̎擾Xbh
+			* GetFilledBuffeȓ҂Ăяo؂藣,擾摜Oɗ߂
+			* ϊv[gꍇ̓obt@̎󂯎肾s,ϊ̓v[ŕɍsĎ󂯎ɃO֓
+			*/
+			struct grab_thread {
+				/**
+				* ϊ̉摜
+				*/
+				struct convert_slot {
+					BGAPI2::Buffer* buffer = NULL;
+					grabbed_frame frame;
+					read_timing timing;
+					bool converted = false;
+					bool ok = false;
+					bool recordLater = false;	//O֓nƂɋL^֓n
+				};
+
+				spsc_ring<grabbed_frame> ring;
+				overflow_policy policy;
+				int waitMs;
+				beumer_data_stream stream;	//XbhLf[^Xg[̃Rs[
+
+				std::shared_ptr<convert_pool> pool;
+				size_t home = 0;
+				std::vector<convert_slot> slots;
+				unsigned long long submitted = 0;	//v[ɓn(orderMutexŕی)
+				unsigned long long emitted = 0;		//O֓nI(orderMutexŕی)
+				bool emitting = false;
+				std::mutex orderMutex;
+				std::condition_variable orderCond;
+
+				std::atomic<bool> enabled{ false };
+				std::atomic<bool> running{ false };
+				std::atomic<bool> waiting{ false };
+				std::atomic<unsigned long long> grabbed{ 0 };
+				std::atomic<unsigned long long> dropped{ 0 };
+				std::mutex waitMutex;
+				std::condition_variable waitCond;
+				std::thread th;
+
+				grab_thread(int capacity, overflow_policy policy, int waitMs, std::shared_ptr<convert_pool> pool) : ring(capacity), policy(policy), waitMs(waitMs), pool(pool) {
+					if (pool)home = pool->assignHome();
 				}
 
-				if (sDeviceID == "") {
-					return false;
+				~grab_thread() {
+					halt();
 				}
 
-				try {
-					//Stop Acquisition
-					pDevice->GetRemoteNode("AcquisitionStop")->Execute();
+				/**
+				* XbhJn
+				* @param[in] s Jnς݂̃f[^Xg[(XbhLRs[)
+				*/
+				void launch(const beumer_data_stream& s) {
+					if (running)return;
+					running = true;
+					stream = s;
+					if (pool) {
+						//ϊ̃obt@ŃhCő󂫂ȂȂ悤,1͎c
+						size_t n = std::min(pool->size(), (size_t)std::max(stream.poolConfig.count - 1, 1));
+						slots.assign(n, convert_slot());
+						submitted = 0;
+						emitted = 0;
+						th = std::thread([this] { loopPooled(); });
+					} else {
+						th = std::thread([this] { loop(); });
+					}
+				}
+
+				/**
+				* Xbh~(O̒g͎c)
+				* ϊv[ɓn摜͕ϊI܂ő҂
+				*/
+				void halt() {
+					running = false;
+					if (th.joinable())th.join();
+					drain();
+					waitCond.notify_all();
+				}
+
+				/**
+				* ϊv[֓n摜SăO֓n܂ő҂
+				*/
+				void drain() {
+					std::unique_lock<std::mutex> lock(orderMutex);
+					orderCond.wait(lock, [this] { return emitted == submitted && !emitting; });
+				}
+
+				/**
+				* sSȉ摜
+				* @param[in] buffer 󂯎obt@
+				* @return bool sS(ǂ߂Ȃfalse. acceptŉ߂Ċm߂)
+				*/
+				static bool isIncomplete(BGAPI2::Buffer* buffer) {
+					try {
+						return buffer->GetIsIncomplete();
+					} catch (BGAPI2::Exceptions::IException& ex) {
+						return false;
+					}
+				}
+
+				/**
+				* 擾[v
+				*/
+				void loop() {
+					while (running) {
+						grabbed_frame frame;
+						if (!stream.read(frame.mat, stream.currentTimeout(), &frame.pyramid))continue;
+						//hCõQƂ܂܂̉摜̓OɓOɕ
+						if (frame.mat.u == NULL)detach(frame);
+						frame.info = stream.info;
+						emit(std::move(frame));
+					}
+				}
+
+				/**
+				* ϊv[g擾[v
+				* obt@󂯎ăv[ɓn,ϊ҂Ɏ̃obt@҂
+				*/
+				void loopPooled() {
+					while (running) {
+						{
+							std::unique_lock<std::mutex> lock(orderMutex);
+							orderCond.wait_for(lock, std::chrono::milliseconds(10), [this] { return submitted - emitted < slots.size(); });
+							if (submitted - emitted >= slots.size())continue;
+						}
+						if (stream.zeroCopy && stream.allocator->held >= stream.maxHeldBuffers) {
+							std::this_thread::sleep_for(std::chrono::microseconds(100));
+							continue;
+						}
+
+						stage_timer timer(false);
+						BGAPI2::Buffer* buffer = stream.receive(stream.currentTimeout(), timer);
+						if (buffer == NULL)continue;
+						//sSȉ摜accept̒ŋL^邽,ɓn摜̋L^҂ďԂۂ
+						if (stream.recorder && isIncomplete(buffer))drain();
+						if (!stream.accept(buffer))continue;
+
+						unsigned long long seq = submitted;
+						convert_slot& slot = slots[seq % slots.size()];
+						slot.buffer = buffer;
+						slot.frame.info = stream.info;
+						slot.converted = false;
+						{
+							std::lock_guard<std::mutex> lock(orderMutex);
+							submitted++;
+						}
+						pool->submit([this, seq] { convertSlot(seq); }, home);
+					}
+				}
+
+				/**
+				* v[̃Xbhł̕ϊ
+				* ϊI摜͎󂯎ɃO֓
+				* @param[in] seq 󂯎
+				*/
+				void convertSlot(unsigned long long seq) {
+					convert_slot& slot = slots[seq % slots.size()];
+					stage_timer timer(false);
+					slot.recordLater = false;
+					slot.ok = stream.convertBuffer(slot.buffer, slot.frame.info, slot.frame.mat, timer, slot.timing, &slot.frame.pyramid, &slot.recordLater);
+					//hCõQƂ܂܂̉摜̓OɓOɕ
+					if (slot.ok && slot.frame.mat.u == NULL)detach(slot.frame);
+
+					std::unique_lock<std::mutex> lock(orderMutex);
+					slot.converted = true;
+					//ɕϊIXbh,Ԃ̑摜܂Ƃ߂ăO֓
+					if (emitting)return;
+					emitting = true;
+					while (emitted < submitted && slots[emitted % slots.size()].converted) {
+						convert_slot& next = slots[emitted % slots.size()];
+						grabbed_frame frame = std::move(next.frame);
+						bool ok = next.ok;
+						BGAPI2::Buffer* recordBuffer = next.recordLater ? next.buffer : NULL;
+						next.frame = grabbed_frame();
+						next.converted = false;
+						next.recordLater = false;
+						lock.unlock();
+						//L^͕ϊ̏Ił͂Ȃ󂯎ɓn
+						if (recordBuffer != NULL)stream.handBack(recordBuffer, frame.info);
+						if (ok)emit(std::move(frame));
+						lock.lock();
+						emitted++;
+						orderCond.notify_all();
+					}
+					emitting = false;
+					orderCond.notify_all();
+				}
+
+				/**
+				* hCõQƂĂ摜̕
+				* @param[in,out] frame 摜
+				*/
+				static void detach(grabbed_frame& frame) {
+					frame.mat = frame.mat.clone();
+					if (!frame.pyramid.empty())frame.pyramid[0] = frame.mat;
+				}
+
+				/**
+				* ǂݍ񂾉摜O֓
+				* @param[in] frame 摜
+				*/
+				void emit(grabbed_frame&& frame) {
+					grabbed++;
+					if (!ring.push(std::move(frame))) {
+						if (policy == overflow_policy::drop_newest) {
+							dropped++;
+							return;
+						}
+						while (running && !ring.push(std::move(frame))) {
+							if (policy == overflow_policy::drop_oldest && ring.size() >= ring.capacity()) {
+								grabbed_frame old;
+								if (ring.pop(old))dropped++;
+							} else {
+								std::this_thread::sleep_for(std::chrono::microseconds(100));
+							}
+						}
+					}
+
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (waiting) {
+						std::lock_guard<std::mutex> lock(waitMutex);
+						waitCond.notify_one();
+					}
+				}
+
+				/**
+				* O摜o
+				* @param[out] frame 摜o
+				* @param[in] timeout ҂[msec](0Ȃ҂Ȃ)
+				* @return bool 摜o
+				*/
+				bool pop(grabbed_frame& frame, int timeout) {
+					if (ring.pop(frame))return true;
+					if (timeout <= 0)return false;
+
+					std::unique_lock<std::mutex> lock(waitMutex);
+					waiting = true;
+					bool popped = waitCond.wait_for(lock, std::chrono::milliseconds(timeout), [&] { return ring.pop(frame) || !running; });
+					waiting = false;
+					return popped && !frame.mat.empty();
+				}
+			};
+			std::shared_ptr<grab_thread> grabber;
+
+			/**
+			* Cxg쓮̉摜zM
+			* SDK̐Vobt@̃Cxgŕϊ,R[obNnextFrame()̑҂֓n
+			* executorgꍇ̓JƂɎs҂̗,Ăяoۂ
+			*/
+			struct frame_dispatcher : std::enable_shared_from_this<frame_dispatcher> {
+				beumer_data_stream stream;
+				frame_callback callback;
+				std::shared_ptr<frame_executor> executor;
+				size_t maxPending;
+
+				std::atomic<bool> attached{ false };
+				std::atomic<unsigned long long> dropped{ 0 };
+				std::mutex mutex;
+				std::deque<grabbed_frame> pending;
+				bool draining = false;
+#ifdef RSDLAB_BAUMER_COROUTINE
+				std::vector<std::pair<std::coroutine_handle<>, grabbed_frame*>> waiters;
+#endif
+
+				frame_dispatcher(frame_callback callback, std::shared_ptr<frame_executor> executor, size_t maxPending)
+					: callback(callback), executor(executor), maxPending(maxPending < 1 ? 1 : maxPending) {}
+
+				/**
+				* Cxg̓o^(擾JnOɌĂ)
+				* @param[in] s f[^Xg[(Cxg̃XbhLRs[)
+				* @return bool o^ł
+				*/
+				bool attach(const beumer_data_stream& s) {
+					if (attached)return true;
+					stream = s;
+					stream.resolveFormat();
+					try {
+						stream.pDataStream->RegisterNewBufferEvent(BGAPI2::Events::EVENTMODE_EVENT_HANDLER);
+						stream.pDataStream->RegisterNewBufferEventHandler(this, (BGAPI2::Events::NewBufferEventHandler)&onNewBuffer);
+					} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+					attached = true;
+					return true;
+				}
+
+				/**
+				* Cxg̓o^(擾~ɌĂ)
+				* nextFrame()ő҂ĂR[`͋̉摜ōĊJ
+				*/
+				void detach() {
+					if (!attached)return;
+					try {
+						stream.pDataStream->UnregisterNewBufferEvent();
+					} catch (BGAPI2::Exceptions::IException& ex) {}
+					attached = false;
+					resume(grabbed_frame());
+				}
+
+				/**
+				* SDKĂ΂Cxgnh
+				* @param[in] owner o^frame_dispatcher
+				* @param[in] buffer 󂯎obt@
+				*/
+				static void BGAPI2CALL onNewBuffer(void* owner, BGAPI2::Buffer* buffer) {
+					((frame_dispatcher*)owner)->dispatch(buffer);
+				}
+
+				/**
+				* 󂯎obt@̕ϊƔzM
+				* @param[in] buffer 󂯎obt@
+				*/
+				void dispatch(BGAPI2::Buffer* buffer) {
+					if (stream.zeroCopy && stream.allocator->held >= stream.maxHeldBuffers) {
+						try {
+							buffer->QueueBuffer();
+						} catch (BGAPI2::Exceptions::IException& ex) {}
+						dropped++;
+						return;
+					}
+
+					stage_timer timer(stream.profiling);
+					stream.timing.wait = 0;
+					grabbed_frame frame;
+					if (!stream.deliver(buffer, frame.mat, timer))return;
+					//hCõQƂ܂܂̉摜̓obt@̍ăL[g悤
+					if (frame.mat.u == NULL)frame.mat = frame.mat.clone();
+					frame.info = stream.info;
+
+					if (!executor) {
+						invoke(frame);
+						return;
+					}
+
+					bool post;
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						if (pending.size() >= maxPending) {
+							pending.pop_front();
+							dropped++;
+						}
+						pending.push_back(std::move(frame));
+						post = !draining;
+						draining = true;
+					}
+					if (post) {
+						std::shared_ptr<frame_dispatcher> self = shared_from_this();
+						executor->post([self] { self->drain(); });
+					}
+				}
+
+				/**
+				* s҂̉摜ɔzM(executor̃Xbhœ)
+				*/
+				void drain() {
+					while (true) {
+						grabbed_frame frame;
+						{
+							std::lock_guard<std::mutex> lock(mutex);
+							if (pending.empty()) {
+								draining = false;
+								return;
+							}
+							frame = std::move(pending.front());
+							pending.pop_front();
+						}
+						invoke(frame);
+					}
+				}
+
+				/**
+				* R[obŇĂяo
+				* @param[in] frame 摜
+				*/
+				void invoke(const grabbed_frame& frame) {
+					stream.counters->latency.record(steadyNow() - frame.info.hostTimestamp);
+					if (callback) {
+						try {
+							callback(frame.mat, frame.info);
+						} catch (std::exception& e) {
+							device_counters::add(stream.counters->errors);
+						}
+					}
+					resume(frame);
+				}
+
+				/**
+				* nextFrame()ő҂ĂR[`̍ĊJ
+				* @param[in] frame n摜
+				*/
+				void resume(const grabbed_frame& frame) {
+#ifdef RSDLAB_BAUMER_COROUTINE
+					std::vector<std::pair<std::coroutine_handle<>, grabbed_frame*>> ready;
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						ready.swap(waiters);
+					}
+					for (auto& w : ready) {
+						*w.second = frame;
+						w.first.resume();
+					}
+#else
+					(void)frame;
+#endif
+				}
+
+#ifdef RSDLAB_BAUMER_COROUTINE
+				/**
+				* ̉摜҂R[`̓o^
+				* @param[in] handle R[`
+				* @param[out] frame 摜̎󂯎
+				* @return bool o^ł(Cxgo^ĂȂΑ҂Ȃ)
+				*/
+				bool wait(std::coroutine_handle<> handle, grabbed_frame* frame) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if (!attached)return false;
+					waiters.emplace_back(handle, frame);
+					return true;
+				}
+#endif
+			};
+			std::shared_ptr<frame_dispatcher> dispatcher;
+
+			/**
+			* ̏(Rs[ԂƊJJŋL)
+			* ꂽƂƊJƂ͊ĎXbhݒ肵,ւ͓ǂݍݑ̃Xbhōs
+			*/
+			struct device_link {
+				enum link_state { connected, lost, ready };
+				std::atomic<int> state{ connected };
+				std::string serialNumber;
+				std::shared_ptr<device_counters> counters;
+				device_config config;						//ĎJn̐ݒ(ێĂȂl̕⊮p)
+
+				std::mutex mutex;							//ȉی삷
+				std::shared_ptr<baumer_device> previous;	//ꂽJ̃Rs[(ǂݍݑ,ĎXbhݒp)
+				std::shared_ptr<baumer_device> replacement;	//JJ
+				std::shared_ptr<baumer_device> retired;		//ւς݂̃J(ĎXbh)
+				uint64_t lostAt = 0;						//ꂽ̂ɋCt[nsec]
+
+				/**
+				* ւς݂̃J
+				* @param[in] all ւO̊JJ邩(I)
+				*/
+				void sweep(bool all) {
+					std::shared_ptr<baumer_device> done;
+					std::shared_ptr<baumer_device> pending;
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						done.swap(retired);
+						if (all && state == ready) {
+							pending.swap(replacement);
+							state = lost;
+						}
+					}
+					if (done)done->retire();
+					if (pending)pending->retire();
+				}
+			};
+
+			/**
+			* ̏Ԃւ̎Q
+			* ւ(*this = *replacement)ł͓Nw܂܂Ȃ̂ŏ,
+			* ւƓɑ̃XbhNǂł(getStatsȂ)Ȃ
+			*/
+			struct link_ref {
+				std::shared_ptr<device_link> ptr;
+
+				link_ref() {}
+				link_ref(const link_ref& other) : ptr(other.ptr) {}
+				link_ref& operator=(const link_ref& other) {
+					if (ptr != other.ptr)ptr = other.ptr;
+					return *this;
+				}
+				link_ref& operator=(const std::shared_ptr<device_link>& other) {
+					ptr = other;
+					return *this;
+				}
+				operator const std::shared_ptr<device_link>&() const { return ptr; }
+				explicit operator bool() const { return (bool)ptr; }
+				device_link* operator->() const { return ptr.get(); }
+			};
+			link_ref link;
+
+			/**
+			* ̊mF(ǂݍ݂̑OɌĂ)
+			* ꂽJ͑҂Ɏs,ĎXbhJJ΍ւ
+			* @return bool ǂݍ߂邩
+			*/
+			bool checkLink() {
+				if (!link || link->state.load(std::memory_order_acquire) == device_link::connected)return true;
+				std::shared_ptr<device_link> l = link;
+				std::lock_guard<std::mutex> lock(l->mutex);
+				if (l->state != device_link::ready) {
+					if (!l->previous)l->previous = std::make_shared<baumer_device>(*this);
+					return false;
+				}
+
+				//vǂރXbhl->mutex邽,ւ̒l͓ǂ܂Ȃ
+				l->retired = l->previous;
+				l->previous.reset();
+				*this = *l->replacement;
+				l->replacement.reset();
+				l->state = device_link::connected;
+				stream.counters->recovery.record(steadyNow() - l->lostAt);
+				device_counters::add(stream.counters->reconnects);
+				return true;
+			}
+
+			/**
+			* ێĂl̐ݒ̍쐬(J֖₢킹Ȃ. Đڑp)
+			* @return device_config ݒ
+			*/
+			device_config getCachedConfig() {
+				device_config config = link->config;
+				config.serialNumber = link->serialNumber;
+				config.firmwareVersion = sFirmwareVersion;
+				if (stream.formatName[0] != 0)config.pixelFormat = stream.formatName;
+				config.exposureNodeName = sExposureNodeName.get();
+				config.exposureMin = fExposureTimeMin;
+				config.exposureMax = fExposureTimeMax;
+				config.hasGain = pGain != NULL;
+				config.gainMin = fGainMin;
+				config.gainMax = fGainMax;
+				if (stream.exposure->isEnabled()) {
+					exposure_stats s = stream.exposure->getStats();
+					config.exposure = s.exposure;
+					config.gain = s.gain;
+				} else {
+					if (hasExposureTime)config.exposure = fExposureTime;
+					if (hasGain)config.gain = fGain;
+				}
+				if (nOffsetX.hasValue && nOffsetY.hasValue && nWidth.hasValue && nHeight.hasValue) {
+					config.roi = cv::Rect((int)nOffsetX.value, (int)nOffsetY.value, (int)nWidth.value, (int)nHeight.value);
+				}
+				config.bufferCount = stream.poolConfig.count;
+				return config;
+			}
+
+			/**
+			* ꂽJ̏Ԃ̈p(ĎXbhŊJJɑ΂ČĂ)
+			* ǂݍ,gK,Io,擾XbhƃCxg쓮̐ݒ߂,BeȂJn
+			* (L^͈pȂ)
+			* @param[in] old ꂽJ
+			* @return bool p
+			*/
+			bool inherit(baumer_device& old) {
+				stream.inherit(old.stream);
+				sTriggerSource = old.sTriggerSource;
+				sTriggerActivation = old.sTriggerActivation;
+				bTriggerMode = old.bTriggerMode;
+				try {
+					applyTrigger();
+				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+				if (old.burstCount > 1 && !setBurst(old.burstCount))return false;
+				if (old.stream.exposure->isEnabled() && !setAutoExposure(true, old.stream.exposure->getConfig()))return false;
+
+				if (old.dispatcher) {
+					dispatcher = std::make_shared<frame_dispatcher>(old.dispatcher->callback, old.dispatcher->executor, old.dispatcher->maxPending);
+				}
+				if (old.grabber && old.grabber->enabled) {
+					grabber = std::make_shared<grab_thread>((int)old.grabber->ring.capacity(), old.grabber->policy, old.grabber->waitMs, old.grabber->pool);
+					grabber->enabled = true;
+				}
+				if (old.capturing || grabber)return startCamera();
+				return true;
+			}
+
+			/**
+			* 擾Xbh,ϊv[֓n摜,Cxg~߂ĎBeI(OɌĂ. s͖)
+			*/
+			void shutdown() {
+				stopGrabbing();
+				stopCamera();
+				if (dispatcher)dispatcher->detach();
+			}
+
+			/**
+			* ꂽJ̌n(Jߎs͖)
+			*/
+			void retire() {
+				shutdown();
+				capturing = false;
+				relese();
+			}
+
+			/**
+			* ^CX^vt̉摜ǂݍ(ǂݍݗp)
+			* @param[out] frame 摜o
+			* @param[in] timeout 擾Xbhgp̑҂[msec]
+			* @return bool 摜ǂݍ߂
+			*/
+			bool readStamped(grabbed_frame& frame, int timeout) {
+				if (!checkLink())return false;
+				if (grabber && grabber->enabled)return handOver(grabber->pop(frame, timeout), frame.info);
+				if (!stream.read(frame.mat))return false;
+				frame.info = stream.info;
+				return handOver(true, frame.info);
+			}
+
+			/**
+			* Ăяo֓n摜̒x̋L^
+			* @param[in] canRead 摜n
+			* @param[in] frameInfo n摜̃^f[^
+			* @return bool canRead̂܂ܕԂ
+			*/
+			inline bool handOver(bool canRead, const frame_info& frameInfo) {
+				if (canRead)stream.counters->latency.record(steadyNow() - frameInfo.hostTimestamp);
+				return canRead;
+			}
+
+			/**
+			* 擾~߂ĐݒύX,obt@ĊmۂčĊJ
+			* (摜TCYςݒ̓obt@̑傫ς邽)
+			* @param[in] change ݒύX
+			* @return bool ύXƍĊJł
+			*/
+			template<typename F>
+			bool reconfigure(F change) {
+				bool wasCapturing = capturing;
+				if (wasCapturing && !stopCamera())return false;
+
+				bool changed = false;
+				try {
+					changed = change();
+				} catch (BGAPI2::Exceptions::IException& ex) { changed = false; }
+
+				if (!stream.releaseBuffers())return false;
+				if (wasCapturing && !startCamera())return false;
+				return changed;
+			}
+
+			/**
+			* ǂݍ݂̐ݒ擾XbhƃCxg쓮֔f
+			* ǂJñf[^Xg[̃Rs[œ,ݒςRs[蒼
+			* (擾Xbh̓J~߂ɓւ,Cxg쓮̓J~߂ēo^)
+			* @return bool fł
+			*/
+			bool applyStreamSettings() {
+				if (!capturing)return true;
+				if (dispatcher)return stopCamera() && startCamera();
+				if (grabber && grabber->running) {
+					grabber->halt();
+					stream.frameInterval = grabber->stream.frameInterval;
+					stream.lastHostTimestamp = grabber->stream.lastHostTimestamp;
+					grabber->launch(stream);
+				}
+				return true;
+			}
+
+			/**
+			* m[h̐ݒ
+			* ̏ItZbgɈˑȂǌ݂ɉe邽,摜̑傫ɊւLbV͂܂Ƃ߂Ĕj
+			* @param[in] n m[h
+			* @param[in] value ݒl
+			* @return bool ݒł
+			*/
+			bool setIntNode(int_node& n, bo_int64 value) {
+				bool canSet = n.set(value);
+				if (canSet) {
+					bo_int64 v = n.value;
+					invalidateGeometry();
+					n.value = v;
+					n.hasValue = true;
+				}
+				return canSet;
+			}
+
+			/**
+			* 摜̑傫ɊւLbV̔j
+			*/
+			void invalidateGeometry() {
+				nWidth.invalidate();
+				nHeight.invalidate();
+				nOffsetX.invalidate();
+				nOffsetY.invalidate();
+				nBinningHorizontal.invalidate();
+				nBinningVertical.invalidate();
+				nDecimationHorizontal.invalidate();
+				nDecimationVertical.invalidate();
+			}
+
+			/**
+			* 悭gm[h̃nh܂Ƃ߂ĉ
+			*/
+			void bindNodes() {
+				nWidth.bind(pDevice, "Width");
+				nHeight.bind(pDevice, "Height");
+				nOffsetX.bind(pDevice, "OffsetX");
+				nOffsetY.bind(pDevice, "OffsetY");
+				nBinningHorizontal.bind(pDevice, "BinningHorizontal");
+				nBinningVertical.bind(pDevice, "BinningVertical");
+				nDecimationHorizontal.bind(pDevice, "DecimationHorizontal");
+				nDecimationVertical.bind(pDevice, "DecimationVertical");
+
+				BGAPI2::NodeMap* nodes = pDevice->GetRemoteNodeList();
+				pAcquisitionStart = pDevice->GetRemoteNode("AcquisitionStart");
+				pAcquisitionStop = pDevice->GetRemoteNode("AcquisitionStop");
+				pAcquisitionAbort = nodes->GetNodePresent("AcquisitionAbort") ? pDevice->GetRemoteNode("AcquisitionAbort") : NULL;
+				pPixelFormat = pDevice->GetRemoteNode("PixelFormat");
+
+				pTriggerMode = pDevice->GetRemoteNode("TriggerMode");
+				pTriggerSelector = nodes->GetNodePresent("TriggerSelector") ? pDevice->GetRemoteNode("TriggerSelector") : NULL;
+				pTriggerSource = nodes->GetNodePresent("TriggerSource") ? pDevice->GetRemoteNode("TriggerSource") : NULL;
+				pTriggerActivation = nodes->GetNodePresent("TriggerActivation") ? pDevice->GetRemoteNode("TriggerActivation") : NULL;
+				pTriggerSoftware = nodes->GetNodePresent("TriggerSoftware") ? pDevice->GetRemoteNode("TriggerSoftware") : NULL;
+				pBurstFrameCount = nodes->GetNodePresent("AcquisitionBurstFrameCount") ? pDevice->GetRemoteNode("AcquisitionBurstFrameCount") : NULL;
+			}
+
+			/**
+			* gK̐ݒ̏
+			* Beɏ߂ȂJł͈x~߂Ă珑
+			* @param[in] change ݏ
+			* @return bool ߂
+			*/
+			template<typename F>
+			bool writeTrigger(F change) {
+				try {
+					change();
+					return true;
+				} catch (BGAPI2::Exceptions::IException& ex) {
+					if (!capturing)return false;
+				}
+				return reconfigure([&] {
+					change();
+					return true;
+				});
+			}
+
+			/**
+			* ێĂgK̐ݒ݂̃ZN^֏
+			* (GenICam̃gKݒ̓ZN^ƂɎ,ZN^؂ւ珑)
+			*/
+			void applyTrigger() {
+				if (pTriggerSelector != NULL)pTriggerSelector->SetString(sTriggerSelector);
+				if (pTriggerSource != NULL && sTriggerSource != "")pTriggerSource->SetString(sTriggerSource);
+				if (pTriggerActivation != NULL && sTriggerActivation != "")pTriggerActivation->SetString(sTriggerActivation);
+				pTriggerMode->SetString(bTriggerMode ? "On" : "Off");
+			}
+
+			/**
+			* sNZtH[}bg,I,QC̃m[h̒T
+			*/
+			void probeNodes() {
+				const char* nodeName[] = { "BGR8Packed" ,"BGR8" ,"BayerRG8" ,"BayerGB8" ,"Mono16" ,"Mono12" ,"BayerRG12","BayerGB12","Mono10","BayerRG10","BayerGB10",
+					"BGR16" ,"BGR12" ,"BGR10" };
+
+				BGAPI2::NodeMap* pixelFormats = pPixelFormat->GetEnumNodeList();
+				for (int i = 0; i < 14; i++) {
+					if (!pixelFormats->GetNodePresent(nodeName[i]))continue;
+					if (!pixelFormats->GetNode(nodeName[i])->IsReadable())continue;
+					pPixelFormat->SetString(nodeName[i]);
+					break;
+				}
+
+				//IԊ֘A
+				if (pDevice->GetRemoteNodeList()->GetNodePresent("ExposureTime")) {
+					sExposureNodeName = "ExposureTime";
+				} else if (pDevice->GetRemoteNodeList()->GetNodePresent("ExposureTimeAbs")) {
+					sExposureNodeName = "ExposureTimeAbs";
+				}
+				pExposureTime = pDevice->GetRemoteNode(sExposureNodeName);
+
+				fExposureTimeMin = pExposureTime->GetDoubleMin();
+				fExposureTimeMax = pExposureTime->GetDoubleMax();
+
+				//QC֘A
+				if (pDevice->GetRemoteNodeList()->GetNodePresent("Gain")) {
+					BGAPI2::Node* pGainSelector = pDevice->GetRemoteNodeList()->GetNode("GainSelector");
+					if ((pGainSelector->GetEnumNodeList()->GetNodePresent("All")) &&
+						(pGainSelector->GetEnumNodeList()->GetNode("All")->GetAvailable())) {
+						pGainSelector->SetValue("All");
+						pGain = pDevice->GetRemoteNodeList()->GetNode("Gain");
+
+						fGainMin = pGain->GetDoubleMin();
+						fGainMax = pGain->GetDoubleMax();
+					}
+				}
+			}
+
+			/**
+			* ݒLbṼm[hƔ͈͂g(TȂ)
+			* @param[in] cached ݒLbV
+			* @return bool g(sT)
+			*/
+			bool applyCachedNodes(const device_config& cached) {
+				try {
+					pPixelFormat->SetString(cached.pixelFormat.c_str());
+
+					sExposureNodeName = cached.exposureNodeName.c_str();
+					pExposureTime = pDevice->GetRemoteNode(sExposureNodeName);
+					fExposureTimeMin = cached.exposureMin;
+					fExposureTimeMax = cached.exposureMax;
+
+					pGain = NULL;
+					if (cached.hasGain) {
+						pDevice->GetRemoteNode("GainSelector")->SetValue("All");
+						pGain = pDevice->GetRemoteNode("Gain");
+						fGainMin = cached.gainMin;
+						fGainMax = cached.gainMax;
+					}
+				} catch (BGAPI2::Exceptions::IException& ex) {
+					pGain = NULL;
+					return false;
+				}
+				return true;
+			}
+
+			friend class VideoCapture;
+
+		public:
+			/**
+			* ݒ
+			* @param[in] it foCXXgCe[^
+			* @param[in] cached ݒLbV(NULLȂm[hT)
+			* @return ݒł
+			*/
+			bool set(BGAPI2::DeviceList::iterator it, const device_config* cached = NULL) {
+				try{
+					it->second->Open();
+					pDevice = it->second;
+					sDeviceID = it->first;
+				} catch (BGAPI2::Exceptions::ResourceInUseException& ex) {
+					return false;
+				} catch (BGAPI2::Exceptions::AccessDeniedException& ex) {
+					return false;
+				}
+
+				if (sDeviceID == "") {
+					return false;
+				}
+
+				try {
+					bindNodes();
+
+					//Stop Acquisition
+					pAcquisitionStop->Execute();
+
+					//SET TRIGGER MODE OFF (FreeRun)
+					pTriggerMode->SetString("Off");
+
+					BGAPI2::NodeMap* nodes = pDevice->GetRemoteNodeList();
+					sFirmwareVersion = nodes->GetNodePresent("DeviceFirmwareVersion") ? pDevice->GetRemoteNode("DeviceFirmwareVersion")->GetString().get() : "";
+					link = std::make_shared<device_link>();
+					link->serialNumber = pDevice->GetSerialNumber().get();
+
+					//t@[EFAȂO̒Tʂg
+					fromCache = cached != NULL && cached->firmwareVersion == sFirmwareVersion && applyCachedNodes(*cached);
+					if (!fromCache)probeNodes();
+				} catch (BGAPI2::Exceptions::IException& ex) { 
+					pDevice->Close();
+					return false; 
+				}
+
+				if (!this->stream.set(pDevice)) {
+					pDevice->Close();
+					return false;
+				}
+				link->counters = stream.counters;
+
+				if (fromCache) {
+					stream.poolConfig.count = cached->bufferCount;
+					try {
+						if (cached->roi.area() > 0 && getRoi() != cached->roi)setRoi(cached->roi);
+						setExposureTime(cached->exposure);
+						if (pGain != NULL)setGain(cached->gain);
+					} catch (BGAPI2::Exceptions::IException& ex) {}
+				}
+				return true;
+			}
+
+			/**
+			* ݂̐ݒ̎擾(ݒLbV̕ۑp)
+			* @return device_config ݒ
+			*/
+			device_config getConfig() {
+				device_config config;
+				config.serialNumber = getSerialNumber().get();
+				config.firmwareVersion = sFirmwareVersion;
+				config.pixelFormat = stream.pPixelFormat->GetString().get();
+				config.exposureNodeName = sExposureNodeName.get();
+				config.exposureMin = fExposureTimeMin;
+				config.exposureMax = fExposureTimeMax;
+				config.hasGain = pGain != NULL;
+				config.gainMin = fGainMin;
+				config.gainMax = fGainMax;
+				config.exposure = getExposureTime();
+				config.gain = pGain != NULL ? getGainVal() : 0;
+				config.roi = getRoi();
+				config.bufferCount = stream.poolConfig.count;
+				return config;
+			}
+
+			/**
+			* ݒLbVJꂽ
+			* @return bool m[h̒Tȗ
+			*/
+			inline bool isFromCache() {
+				return fromCache;
+			}
+
+			/**
+			* JڑĂ邩
+			* (VideoCapture::startDeviceMonitorŊĎĂꍇ̂ݔꂽƂ)
+			* @return bool ڑĂ邩(Ă獷ւ܂łfalse)
+			*/
+			inline bool isConnected() {
+				return !link || link->state.load(std::memory_order_acquire) == device_link::connected;
+			}
+
+			/**
+			* JJւ̍ւ
+			* read()͖mF邽,read()gȂꍇ(Cxg쓮Ȃ)ɒIɌĂ
+			* (ĂԂ͐ݒ̕ύXȂread()ȊȎȂ)
+			* @return bool ڑĂ邩
+			*/
+			inline bool reconnect() {
+				return checkLink();
+			}
+
+			/**
+			* JJn
+			* @return bool JJnł
+			*/
+			bool startCamera() {
+				if (capturing)return true;
+				try {
+					if (dispatcher && !dispatcher->attach(stream))return false;
+					if (!stream.startStream())return false;
+					pAcquisitionStart->Execute();
+				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+
+				capturing = true;
+				if (grabber && grabber->enabled)grabber->launch(stream);
+				return true;
+			}
+
+			/**
+			* JI
+			* JIł
+			*/
+			bool stopCamera() {
+				if (!capturing)return true;
+				if (grabber)grabber->halt();
+				try {
+					if (pAcquisitionAbort != NULL) {
+						pAcquisitionAbort->Execute();
+					}
+
+					pAcquisitionStop->Execute();
+
+					if (!stream.stopStream())return false;
+				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+				if (dispatcher)dispatcher->detach();
+				capturing = false;
+				return true;
+			}
+
+			/**
+			* J̃N[Y
+			* @param bool N[Ył
+			*/
+			bool close() {
+				pDevice->Close();
+				return true;
+			}
+
+			/**
+			* J
+			* @return bool Jł
+			*/
+			bool relese() {
+				bool canRelese = true;
+				if (stream.recorder) {
+					stream.recorder->close();
+					stream.recorder.reset();
+				}
+				try {
+					canRelese &= stream.release();
+					pDevice->Close();
+				} catch (BGAPI2::Exceptions::IException& ex) {
+					return false;
+				}
+
+				return canRelese;
+			}
+
+			/**
+			* 摜ǂݍ
+			* @param[out] mat 摜o
+			* @return bool 摜ǂݍ߂
+			*/
+			bool read(cv::Mat& mat) {
+				return read(mat, -1);
+			}
+
+			/**
+			* ^f[^t̉摜ǂݍ
+			* @param[out] mat 摜o
+			* @param[out] info 摜̃^f[^(sSȉ摜Ŏsꍇincompleteݒ肳)
+			* @return bool 摜ǂݍ߂
+			*/
+			bool read(cv::Mat& mat, frame_info& info) {
+				return read(mat, info, -1);
+			}
+
+			/**
+			* ҂Ԃw肵摜ǂݍ
+			* @param[out] mat 摜o
+			* @param[in] timeout ҂[msec](0Ȃ҂Ȃ,ȂsetReadTimeout̐ݒ)
+			* @return bool 摜ǂݍ߂
+			*/
+			bool read(cv::Mat& mat, int timeout) {
+				frame_info info;
+				return read(mat, info, timeout);
+			}
+
+			/**
+			* ҂Ԃw肵^f[^t̉摜ǂݍ
+			* @param[out] mat 摜o
+			* @param[out] info 摜̃^f[^(sSȉ摜Ŏsꍇincompleteݒ肳)
+			* @param[in] timeout ҂[msec](0Ȃ҂Ȃ,ȂsetReadTimeout̐ݒ)
+			* @return bool 摜ǂݍ߂
+			*/
+			bool read(cv::Mat& mat, frame_info& info, int timeout) {
+				if (!checkLink() || dispatcher)return false;
+				if (grabber && grabber->enabled) {
+					grabbed_frame frame;
+					if (!handOver(grabber->pop(frame, timeout < 0 ? grabber->waitMs : timeout), frame.info))return false;
+					mat = frame.mat;
+					info = frame.info;
+					return true;
+				}
+				bool canRead = handOver(stream.read(mat, timeout < 0 ? stream.currentTimeout() : timeout), stream.info);
+				info = stream.info;
+				return canRead;
+			}
+
+			/**
+			* k摜(s~bh)t̉摜ǂݍ
+			* k摜͕ϊƍ킹ăZT̉摜邽,ǂݍ݌ɏky
+			* (setPyramid()Œiw肵Ă. 擾XbhgpȊO͑Opyramid̗̈ėp)
+			* @param[out] mat 摜o
+			* @param[out] pyramid k摜(pyramid[0]matƓ摜,pyramid[i]1/2^ȋ傫)
+			* @param[in] timeout ҂[msec](0Ȃ҂Ȃ,ȂsetReadTimeout̐ݒ)
+			* @return bool 摜ǂݍ߂
+			*/
+			bool read(cv::Mat& mat, std::vector<cv::Mat>& pyramid, int timeout = -1) {
+				if (!checkLink() || dispatcher)return false;
+				if (grabber && grabber->enabled) {
+					grabbed_frame frame;
+					if (!handOver(grabber->pop(frame, timeout < 0 ? grabber->waitMs : timeout), frame.info))return false;
+					mat = frame.mat;
+					pyramid.swap(frame.pyramid);
+					return true;
+				}
+				return handOver(stream.read(mat, timeout < 0 ? stream.currentTimeout() : timeout, &pyramid), stream.info);
+			}
+
+			/**
+			* ҂ɉ摜ǂݍ
+			* ͂Ă摜΂falseԂ,J1Xbhŏł
+			* @param[out] mat 摜o
+			* @return bool 摜ǂݍ߂
+			*/
+			inline bool tryRead(cv::Mat& mat) {
+				return read(mat, 0);
+			}
+
+			/**
+			* ҂Ƀ^f[^t̉摜ǂݍ
+			* @param[out] mat 摜o
+			* @param[out] info 摜̃^f[^
+			* @return bool 摜ǂݍ߂
+			*/
+			inline bool tryRead(cv::Mat& mat, frame_info& info) {
+				return read(mat, info, 0);
+			}
+
+			/**
+			* read()̑҂Ԃ̐ݒ
+			* (擾XbhgpstartGrabbingwaitMsg)
+			* @param[in] timeout ҂[msec](K͏)
+			*/
+			inline void setReadTimeout(int timeout) {
+				stream.timeoutMs = timeout;
+				applyStreamSettings();
+			}
+
+			/**
+			* ݂read()̑҂Ԃ̎擾
+			* @return int ҂[msec]
+			*/
+			inline int getReadTimeout() {
+				return stream.currentTimeout();
+			}
+
+			/**
+			* ҂Ԃ̓K̐ݒ
+			* L͎󂯎Ԋufactor{(minTimeoutȏ,setReadTimeout̒lȉ)҂Ԃɂ
+			* (gK[hł͉摜̊ԊugKɂȂ邽,ɂ邩傫Ă)
+			* @param[in] enable K邩
+			* @param[in] factor 󂯎Ԋuɑ΂{
+			* @param[in] minTimeout ҂Ԃ̉[msec]
+			*/
+			inline void setAdaptiveTimeout(bool enable, double factor = 3.0, int minTimeout = 5) {
+				stream.adaptiveTimeout = enable;
+				stream.timeoutFactor = factor;
+				stream.minTimeoutMs = minTimeout;
+				applyStreamSettings();
+			}
+
+			/**
+			* p̎擾XbhJn
+			* ȍ~read()̓O̎oɂȂ,̃J̑҂ɉeȂ
+			* @param[in] capacity O̗e
+			* @param[in] policy OꂽƂ̓
+			* @param[in] waitMs read()摜҂ő厞[msec](0Ȃ҂Ȃ)
+			* @param[in] pool ϊXbhv[(nullptrȂ擾Xbhŕϊ.̃JŋLł)
+			* @return bool Jnł
+			*/
+			bool startGrabbing(int capacity = 4, overflow_policy policy = overflow_policy::drop_oldest, int waitMs = 1000, std::shared_ptr<convert_pool> pool = nullptr) {
+				if (!clearFrameCallback())return false;
+				stopGrabbing();
+				grabber = std::make_shared<grab_thread>(capacity, policy, waitMs, pool);
+				grabber->enabled = true;
+				if (!capturing)return startCamera();
+				grabber->launch(stream);
+				return true;
+			}
+
+			/**
+			* 擾Xbh̒~
+			* @return bool ~ł
+			*/
+			bool stopGrabbing() {
+				if (!grabber)return true;
+				grabber->enabled = false;
+				grabber->halt();
+				return true;
+			}
+
+			/**
+			* 擾Xbh삵Ă邩
+			* @return bool 삵Ă邩
+			*/
+			inline bool isGrabbing() {
+				return grabber && grabber->running;
+			}
+
+			/**
+			* Cxg쓮̓ǂݍ݂̊Jn
+			* Vobt@̃CxgƂɕϊcallbackĂԂ,JƂ̎擾XbhvȂ
+			* (ȍ~read()͎s.擾ɌĂ񂾏ꍇ͈x~߂ăCxgo^)
+			* @param[in] callback 摜ƂɌĂ΂֐(ȂnextFrame()Ŏ󂯎邾)
+			* @param[in] executor callbacksXbhv[(NULLȂSDK̃Cxg̃XbhŒڌĂ)
+			* @param[in] maxPending executorŎs҂ɂł摜(͌Â摜̂Ă)
+			* @return bool Jnł
+			*/
+			bool setFrameCallback(frame_callback callback, std::shared_ptr<frame_executor> executor = nullptr, size_t maxPending = 4) {
+				stopGrabbing();
+				bool wasCapturing = capturing;
+				if (wasCapturing && !stopCamera())return false;
+				dispatcher = std::make_shared<frame_dispatcher>(callback, executor, maxPending);
+				if (wasCapturing)return startCamera();
+				return true;
+			}
+
+			/**
+			* Cxg쓮̓ǂݍ݂̏I(read()ɂǂݍ݂ɖ߂)
+			* @return bool Ił
+			*/
+			bool clearFrameCallback() {
+				if (!dispatcher)return true;
+				bool wasCapturing = capturing;
+				if (wasCapturing && !stopCamera())return false;
+				dispatcher.reset();
+				if (wasCapturing)return startCamera();
+				return true;
+			}
+
+			/**
+			* Cxg쓮̓ǂݍݒ
+			* @return bool setFrameCallbackL
+			*/
+			inline bool hasFrameCallback() {
+				return (bool)dispatcher;
+			}
+
+#ifdef RSDLAB_BAUMER_COROUTINE
+			/**
+			* nextFrame()̑҂
+			*/
+			struct frame_awaiter {
+				std::shared_ptr<frame_dispatcher> dispatcher;
+				grabbed_frame frame;
+
+				bool await_ready() {
+					return !dispatcher || !dispatcher->attached;
+				}
+				bool await_suspend(std::coroutine_handle<> handle) {
+					return dispatcher->wait(handle, &frame);
+				}
+				grabbed_frame await_resume() {
+					return std::move(frame);
+				}
+			};
+
+			/**
+			* ̉摜҂(C++20̃R[`p)
+			* co_await dev.nextFrame()͉摜͂Cxg̃Xbh(executorw莞͂̃Xbh)ōĊJ
+			* setFrameCallbackŊJnĂȂꍇ,J~܂ꍇ͋̉摜łɍĊJ
+			* @return frame_awaiter ҂
+			*/
+			inline frame_awaiter nextFrame() {
+				return frame_awaiter{ dispatcher, grabbed_frame() };
+			}
+#endif
+
+			/**
+			* OĎ̂Ă摜̎擾
+			* (Cxg쓮łexecutor̎s҂Ď̂Ă摜)
+			* @return unsigned long long ̂Ă摜
+			*/
+			inline unsigned long long getDropCount() {
+				unsigned long long n = grabber ? (unsigned long long)grabber->dropped : 0;
+				if (dispatcher)n += dispatcher->dropped;
+				return n;
+			}
+
+			/**
+			* Oɗ܂Ă摜̎擾
+			* @return size_t 摜
+			*/
+			inline size_t getQueuedFrames() {
+				return grabber ? grabber->ring.size() : 0;
+			}
+
+			/**
+			* ṽXibvVbg̎擾
+			* ǂݍݒłCӂ̃XbhĂׂ
+			* (JJւ̍ւƂ͔̏ԂmutexŔr)
+			* @return device_stats v
+			*/
+			device_stats getStats() {
+				if (!link)return collectStats();
+				std::lock_guard<std::mutex> lock(link->mutex);
+				return collectStats();
+			}
+
+		private:
+			/**
+			* v̎W(getStats獷ւƔrČĂ)
+			* @return device_stats v
+			*/
+			device_stats collectStats() {
+				device_stats stats;
+				const device_counters& c = *stream.counters;
+				stats.delivered = c.delivered.load(std::memory_order_relaxed);
+				stats.incomplete = c.incomplete.load(std::memory_order_relaxed);
+				stats.timeouts = c.timeouts.load(std::memory_order_relaxed);
+				stats.lost = c.lost.load(std::memory_order_relaxed);
+				stats.errors = c.errors.load(std::memory_order_relaxed);
+				stats.connected = isConnected() ? 1 : 0;
+				stats.disconnects = c.disconnects.load(std::memory_order_relaxed);
+				stats.reconnects = c.reconnects.load(std::memory_order_relaxed);
+				stats.convert = latency_summary(c.convert);
+				stats.latency = latency_summary(c.latency);
+				stats.recovery = latency_summary(c.recovery);
+				if (stats.connected)stream.getDriverStats(stats);
+				if (grabber) {
+					stats.grabQueued = grabber->ring.size();
+					stats.grabDropped = grabber->dropped;
+				}
+				return stats;
+			}
+
+		public:
+
+			/**
+			* v̔j(hCo̓v͏)
+			*/
+			void resetStats() {
+				stream.counters->reset();
+			}
+
+			/**
+			* ϊ̉摜̃t@Cւ̋L^̊Jn
+			* 󂯎obt@̂܂I/OXbh֓n,݌ɍăL[
+			* (read()Ȃǂ̕ῗ̂܂܎g邪,L^̓[Rs[ǂݍ݂ɂȂȂ)
+			* ݑ҂̃obt@͎擾ɎgȂ,setBufferPoolŃobt@𑝂₵Ă
+			* 擾ɌĂ񂾏ꍇ͈x~߂ĂJn
+			* @param[in] path o͐
+			* @param[in] capacity t@C̑傫[byte](Ɋmۂ,Iɏ񂾑傫ɐ؂l߂)
+			* @param[in] queueSize ݑ҂ɂł摜(0Ȃobt@̔)
+			* @return bool Jnł
+			*/
+			bool startRecording(const std::string& path, uint64_t capacity, size_t queueSize = 0) {
+				if (!stopRecording())return false;
+				if (queueSize == 0)queueSize = (size_t)std::max(1, stream.poolConfig.count / 2);
+
+				std::shared_ptr<raw_recorder> recorder = std::make_shared<raw_recorder>();
+				if (!recorder->open(path, capacity, queueSize, getSerialNumber().get(), getModel().get()))return false;
+
+				bool wasCapturing = capturing;
+				if (wasCapturing && !stopCamera())return false;
+				stream.recorder = recorder;
+				if (wasCapturing)return startCamera();
+				return true;
+			}
+
+			/**
+			* L^̏I
+			* ݑ҂̉摜Sďł
+			* @return bool Ił
+			*/
+			bool stopRecording() {
+				if (!stream.recorder)return true;
+				bool wasCapturing = capturing;
+				if (wasCapturing && !stopCamera())return false;
+				stream.recorder->close();
+				stream.recorder.reset();
+				if (wasCapturing)return startCamera();
+				return true;
+			}
+
+			/**
+			* L^
+			* @return bool L^
+			*/
+			inline bool isRecording() {
+				return stream.recorder && stream.recorder->isOpen();
+			}
 
-					//SET TRIGGER MODE OFF (FreeRun)
-					pDevice->GetRemoteNode("TriggerMode")->SetString("Off");
+			/**
+			* L^̓v̎擾
+			* @return recorder_stats v(L^ĂȂΑS0)
+			*/
+			inline recorder_stats getRecordingStats() {
+				return stream.recorder ? stream.recorder->getStats() : recorder_stats();
+			}
 
-					const char* nodeName[] = { "BGR8Packed" ,"BGR8" ,"BayerRG8" ,"BayerGB8" ,"Mono16" ,"Mono12" ,"BayerRG12","BayerGB12","Mono10","BayerRG10","BayerGB10",
-						"BGR16" ,"BGR12" ,"BGR10" };
+			/**
+			* ǂݍ݂̋ԂƂ̎Ԍv̗L
+			* (̂Ƃ͎vǂ܂Ȃߓǂݍׂ݂͕̕ςȂ)
+			* @param[in] enable v邩
+			*/
+			void setProfiling(bool enable) {
+				stream.profiling = enable;
+				applyStreamSettings();
+			}
 
-					for (int i = 0; i < 14; i++) {
-						if (!pDevice->GetRemoteNode("PixelFormat")->GetEnumNodeList()->GetNodePresent(nodeName[i]))continue;
-						if (!pDevice->GetRemoteNode("PixelFormat")->GetEnumNodeList()->GetNode(nodeName[i])->IsReadable())continue;
-						pDevice->GetRemoteNode("PixelFormat")->SetString(nodeName[i]);
-						break;
-					}
+			/**
+			* O̓ǂݍ݂̋ԂƂ̏v
+			* (startGrabbing͎擾XbhŌv邽ߍXVȂ)
+			* @return read_timing v
+			*/
+			inline read_timing getReadTiming() {
+				return stream.timing;
+			}
 
-					//IԊ֘A
-					if (pDevice->GetRemoteNodeList()->GetNodePresent("ExposureTime")) {
-						sExposureNodeName = "ExposureTime";
-					} else if (pDevice->GetRemoteNodeList()->GetNodePresent("ExposureTimeAbs")) {
-						sExposureNodeName = "ExposureTimeAbs";
-					}
-					pExposureTime = pDevice->GetRemoteNode(sExposureNodeName);
+			/**
+			* [Rs[ǂݍ݂̐ݒ
+			* LBGR8/Monon̉摜hCõobt@𒼐ڎQƂ,
+			* Ōcv::Matꂽ_Ńobt@ăL[
+			* (JOɉ摜邱)
+			* @param[in] enable [Rs[Lɂ邩
+			* @param[in] maxHeld AvP[Vɕێłobt@
+			*/
+			inline void setZeroCopy(bool enable, int maxHeld = 3) {
+				stream.zeroCopy = enable;
+				stream.maxHeldBuffers = maxHeld;
+				applyStreamSettings();
+			}
 
-					fExposureTimeMin = pExposureTime->GetDoubleMin();
-					fExposureTimeMax = pExposureTime->GetDoubleMax();
+			/**
+			* AvP[VێĂobt@̎擾
+			* @return int ێ̃obt@
+			*/
+			inline int getHeldBuffers() {
+				return stream.allocator ? (int)stream.allocator->held : 0;
+			}
 
-					//QC֘A
-					if (pDevice->GetRemoteNodeList()->GetNodePresent("Gain")) {
-						BGAPI2::Node* pGainSelector = pDevice->GetRemoteNodeList()->GetNode("GainSelector");
-						if ((pGainSelector->GetEnumNodeList()->GetNodePresent("All")) &&
-							(pGainSelector->GetEnumNodeList()->GetNode("All")->GetAvailable())) {
-							pGainSelector->SetValue("All");
-							pGain = pDevice->GetRemoteNodeList()->GetNode("Gain");
+			/**
+			* obNvbV[̊mF
+			* @return bool ێ̃obt@ɒBĂ邩(̂Ƃread()͎s)
+			*/
+			inline bool isBackPressured() {
+				return stream.zeroCopy && getHeldBuffers() >= stream.maxHeldBuffers;
+			}
 
-							fGainMin = pGain->GetDoubleMin();
-							fGainMax = pGain->GetDoubleMax();
-						}
-					}
-				} catch (BGAPI2::Exceptions::IException& ex) { 
-					pDevice->Close();
-					return false; 
-				}
+			/**
+			* 擾obt@v[̐ݒ
+			* 擾łΈx~,obt@ĊmۂčĊJ
+			* @param[in] config v[̐ݒ
+			* @return bool ݒł
+			*/
+			bool setBufferPool(const buffer_pool_config& config) {
+				if (config.count <= 0)return false;
+				return reconfigure([&] {
+					stream.poolConfig = config;
+					return true;
+				});
+			}
 
-				if (!this->stream.set(pDevice)) {
-					pDevice->Close();
-					return false;
-				}
-				return true;
+			/**
+			* sNZtH[}bg̐ݒ
+			* 擾łΈx~,obt@ĊmۂčĊJ
+			* (getRemoteNodeŒڕύXꍇ̊֐J̍ĊJKv)
+			* @param[in] name GenICam̃sNZtH[}bg
+			* @return bool ݒł
+			*/
+			bool setPixelFormat(BGAPI2::String name) {
+				if (toPixelFormat(name.get()) == pixel_format::Unknown)return false;
+				return reconfigure([&] {
+					pPixelFormat->SetString(name);
+					invalidateGeometry();
+					return stream.resolveFormat();
+				});
 			}
 
 			/**
-			* JJn
-			* @return bool JJnł
+			* 10/12bit摜̃rbg[x̐ݒ
+			* Lɂ16bitւ̃Vtgs킸,J̃rbg[x̂܂ܕԂ
+			* @param[in] enable ̃rbg[x̂܂ܕԂ
 			*/
-			bool startCamera() {
-				if (capturing)return true;
-				try {
-					if (!stream.startStream())return false;
-					pDevice->GetRemoteNode("AcquisitionStart")->Execute();
-				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+			inline void setNativeBitDepth(bool enable) {
+				stream.nativeBitDepth = enable;
+				stream.convert = getConverter(stream.format, enable, stream.convertOptions);
+				applyStreamSettings();
+			}
 
-				capturing = true;
-				return true;
+			/**
+			* Bayer`̃fUCN@̐ݒ
+			* (10/12bitBayerBGRɕϊ. noneȂBayer̂܂ܕԂ)
+			* @param[in] method fUCN@
+			*/
+			inline void setDemosaic(demosaic_method method) {
+				stream.convertOptions.demosaic = method;
+				stream.convert = getConverter(stream.format, stream.nativeBitDepth, stream.convertOptions);
+				applyStreamSettings();
 			}
 
 			/**
-			* JI
-			* JIł
+			* ǂݍމ摜̌^Ƒ傫̐ݒ
+			* read()͎w肵^Ƒ傫̉摜Ԃ.sNZtH[}bg̓JΉ̂ϊłŷI,
+			* krbg̕ϊ̓fUCNȂǂ1̑ōs
+			* (擾łΈx~,obt@ĊmۂčĊJ)
+			* @param[in] spec o͂̎w(lȂw)
+			* @param[in] negotiate sNZtH[}bgIђ(falseȂ獡̃tH[}bgϊ)
+			* @return bool ݒł
 			*/
-			bool stopCamera() {
-				if (!capturing)return true;
-				try {
-					if (pDevice->GetRemoteNodeList()->GetNodePresent("AcquisitionAbort")) {
-						pDevice->GetRemoteNode("AcquisitionAbort")->Execute();
+			bool setOutput(const output_spec& spec, bool negotiate = true) {
+				if (spec.scale <= 0 || spec.scale > 1)return false;
+				if (spec.type >= 0) {
+					int depth = CV_MAT_DEPTH(spec.type);
+					int channels = CV_MAT_CN(spec.type);
+					if ((depth != CV_8U && depth != CV_16U) || (channels != 1 && channels != 3))return false;
+				}
+				std::string name = negotiate && spec.type >= 0 ? chooseFormat(spec) : "";
+				return reconfigure([&] {
+					stream.convertOptions.output = spec;
+					if (name != "" && name != stream.formatName) {
+						pPixelFormat->SetString(name.c_str());
+						invalidateGeometry();
 					}
+					return stream.resolveFormat();
+				});
+			}
 
-					pDevice->GetRemoteNode("AcquisitionStop")->Execute();
+			/**
+			* ϊƍ킹čk摜(s~bh)̒i̐ݒ
+			* (擾łΈx~čĊJ)
+			* @param[in] levels i(0ȂȂ. 1Ȃ甼̑傫̉摜̂)
+			* @return bool ݒł
+			*/
+			bool setPyramid(int levels) {
+				if (levels < 0)return false;
+				bool wasCapturing = capturing;
+				if (wasCapturing && !stopCamera())return false;
+				stream.pyramidLevels = levels;
+				return !wasCapturing || startCamera();
+			}
 
-					if (!stream.stopStream())return false;
-				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
-				capturing = false;
-				return true;
+			/**
+			* k摜(s~bh)̒i̎擾
+			* @return int i
+			*/
+			inline int getPyramid() {
+				return stream.pyramidLevels;
 			}
 
 			/**
-			* J̃N[Y
-			* @param bool N[Ył
+			* ǂݍމ摜̌^Ƒ傫̎w̎擾
+			* @return output_spec o͂̎w
 			*/
-			bool close() {
-				pDevice->Close();
-				return true;
+			inline output_spec getOutput() {
+				return stream.convertOptions.output;
 			}
 
 			/**
-			* J
-			* @return bool Jł
+			* o͂̎wɑ΂ĕϊłysNZtH[}bg̑I
+			* @param[in] spec o͂̎w
+			* @return std::string GenICam̃sNZtH[}bg(IׂȂ΋)
 			*/
-			bool relese() {
-				bool canRelese = true;
+			std::string chooseFormat(const output_spec& spec) {
+				std::string best;
+				int bestCost = -1;
 				try {
-					canRelese &= stream.release();
-					pDevice->Close();
+					BGAPI2::NodeMap* pixelFormats = pPixelFormat->GetEnumNodeList();
+					for (const auto& entry : pixelFormatNames) {
+						if (!pixelFormats->GetNodePresent(entry.name))continue;
+						if (!pixelFormats->GetNode(entry.name)->IsReadable())continue;
+						int cost = getOutputCost(entry.format, spec, stream.convertOptions.demosaic);
+						if (cost < 0 || (bestCost >= 0 && cost >= bestCost))continue;
+						best = entry.name;
+						bestCost = cost;
+					}
 				} catch (BGAPI2::Exceptions::IException& ex) {
-					return false;
+					return "";
 				}
+				return best;
+			}
 
-				return canRelese;
+			/**
+			* sNZtH[}bg̎擾
+			* @return pixel_format sNZtH[}bg
+			*/
+			inline pixel_format getPixelFormat() {
+				if (stream.format == pixel_format::Unknown)stream.resolveFormat();
+				return stream.format;
 			}
 
 			/**
-			* 摜ǂݍ
-			* @param[out] mat 摜o
-			* @return bool 摜ǂݍ߂
+			* 擾obt@v[̐ݒ̎擾
+			* @return buffer_pool_config v[̐ݒ
 			*/
-			bool read(cv::Mat& mat) {
-				return stream.read(mat);
+			inline buffer_pool_config getBufferPool() {
+				return stream.poolConfig;
 			}
 
 			/**
@@ -548,7 +3339,12 @@ namespace baumer {
 			* @return double I
 			*/
 			inline double getExposureTime() {
-				return pExposureTime->GetDouble();
+				if (stream.exposure && stream.exposure->isEnabled())return stream.exposure->getStats().exposure;
+				if (!hasExposureTime) {
+					fExposureTime = pExposureTime->GetDouble();
+					hasExposureTime = true;
+				}
+				return fExposureTime;
 			}
 
 			/**
@@ -564,6 +3360,9 @@ namespace baumer {
 				}
 
 				pExposureTime->SetDouble(dTime);
+				fExposureTime = dTime;
+				hasExposureTime = true;
+				if (stream.exposure && stream.exposure->isEnabled())stream.exposure->sync(dTime, stream.exposure->getStats().gain);
 			}
 
 			/**
@@ -587,7 +3386,12 @@ namespace baumer {
 			* @return double QC
 			*/
 			inline double getGainVal() {
-				return pGain->GetDouble();
+				if (stream.exposure && stream.exposure->isEnabled() && pGain != NULL)return stream.exposure->getStats().gain;
+				if (!hasGain) {
+					fGain = pGain->GetDouble();
+					hasGain = true;
+				}
+				return fGain;
 			}
 
 			/**
@@ -603,6 +3407,69 @@ namespace baumer {
 				}
 				
 				pGain->SetDouble(dGain);
+				fGain = dGain;
+				hasGain = true;
+				if (stream.exposure && stream.exposure->isEnabled())stream.exposure->sync(stream.exposure->getStats().exposure, dGain);
+			}
+
+			/**
+			* Io(IԂƃQC̎)̐ݒ
+			* ϊ̓rŃobt@ԈqXgO,maxRateȉ̕pxŘIԂƃQC̃m[hXV
+			* AvP[Vŉ摜̖邳𑪂Kv͖
+			* (QCdBƂĈ,IԂɒBĂグ. LȊԂsetExposureTime/setGain͏lɂȂ)
+			* @param[in] enable Lɂ邩
+			* @param[in] config ݒ
+			* @return bool ݒł
+			*/
+			bool setAutoExposure(bool enable, const exposure_config& config = exposure_config()) {
+				if (!enable) {
+					if (stream.exposure->isEnabled()) {
+						exposure_stats s = stream.exposure->getStats();
+						stream.exposure->disable();
+						fExposureTime = s.exposure;
+						hasExposureTime = true;
+						fGain = s.gain;
+						hasGain = pGain != NULL;
+					}
+					return true;
+				}
+				if (pExposureTime == NULL || config.maxRate <= 0 || config.target <= 0 || config.target >= 1)return false;
+
+				BGAPI2::Node* exposureNode = pExposureTime;
+				BGAPI2::Node* gainNode = config.useGain ? pGain : NULL;
+				try {
+					double gain = pGain != NULL ? getGainVal() : 0;
+					stream.exposure->configure(config, getExposureTime(), fExposureTimeMin, fExposureTimeMax,
+						gain, gainNode != NULL ? fGainMin : gain, gainNode != NULL ? fGainMax : gain,
+						[exposureNode, gainNode](double exposure, double gain) {
+						try {
+							exposureNode->SetDouble(exposure);
+							if (gainNode != NULL)gainNode->SetDouble(gain);
+						} catch (BGAPI2::Exceptions::IException& ex) {
+							return false;
+						}
+						return true;
+					});
+				} catch (BGAPI2::Exceptions::IException& ex) {
+					return false;
+				}
+				return true;
+			}
+
+			/**
+			* IoL
+			* @return bool L
+			*/
+			inline bool getAutoExposure() {
+				return stream.exposure && stream.exposure->isEnabled();
+			}
+
+			/**
+			* IȍԂ̎擾
+			* @return exposure_stats (ϋPx,XV,݂̘IԂƃQC)
+			*/
+			inline exposure_stats getExposureStats() {
+				return stream.exposure ? stream.exposure->getStats() : exposure_stats();
 			}
 
 			/**
@@ -610,63 +3477,271 @@ namespace baumer {
 			* @return cv::Size ʃTCY
 			*/
 			inline cv::Size getSize() {
-				int width = pDevice->GetRemoteNode("Width")->GetInt();
-				int height = pDevice->GetRemoteNode("Height")->GetInt();
+				int width = (int)nWidth.get(0);
+				int height = (int)nHeight.get(0);
 
 				return cv::Size(width, height);
 			}
 
+			/**
+			* LbVĂm[h̒lj
+			* (J̎IgetRemoteNodeŒڃm[hύXꍇɌĂ)
+			*/
+			void refreshNodeCache() {
+				invalidateGeometry();
+				hasExposureTime = false;
+				hasGain = false;
+			}
+
 			/**
 			* ʃTCY̐ݒ(T|[gȂJ)
+			* 擾łΈx~,obt@ĊmۂčĊJ
 			* @param[in] size ʃTCY
 			* @return bool ݒύXł
 			*/
 			bool setSize(cv::Size size) {
-				if (!setWidth(size.width))return false;
-				if (!setHeight(size.height))return false;
-				return true;
+				return reconfigure([&] {
+					if (!setIntNode(nWidth, size.width))return false;
+					if (!setIntNode(nHeight, size.height))return false;
+					return true;
+				});
 			}
 
 			/**
 			* ʃTCY()̐ݒ(T|[gȂJ)
+			* 擾łΈx~,obt@ĊmۂčĊJ
 			* @param[in] size ʃTCY()
 			* @return bool ݒύXł
 			*/
 			bool setWidth(int width) {
-				if (!pDevice->GetRemoteNode("Width")->IsWriteable())return false;
-				bo_int64 iImageWidthMin = pDevice->GetRemoteNode("Width")->GetIntMin();
-				bo_int64 iImageWidthMax = pDevice->GetRemoteNode("Width")->GetIntMax();
-				bo_int64 iImageWidthInc = pDevice->GetRemoteNode("Width")->GetIntInc();
-
-				bo_int64 widthvalue = (width / iImageWidthInc) * iImageWidthInc;
-
-				if (widthvalue < iImageWidthMin) { widthvalue = iImageWidthMin; }
-				if (widthvalue > iImageWidthMax) { widthvalue = iImageWidthMax; }
-
-				pDevice->GetRemoteNode("Width")->SetInt(widthvalue);
-				return true;
+				return reconfigure([&] { return setIntNode(nWidth, width); });
 			}
 
 			/**
 			* ʃTCY(c)̐ݒ(T|[gȂJ)
+			* 擾łΈx~,obt@ĊmۂčĊJ
 			* @param[in] size ʃTCY(c)
 			* @return bool ݒύXł
 			*/
 			bool setHeight(int height) {
-				if (!pDevice->GetRemoteNode("Height")->IsWriteable())return false;
-				bo_int64 iImageHeightMin = pDevice->GetRemoteNode("Height")->GetIntMin();
-				bo_int64 iImageHeightMax = pDevice->GetRemoteNode("Height")->GetIntMax();
-				bo_int64 iImageHeightInc = pDevice->GetRemoteNode("Height")->GetIntInc();
+				return reconfigure([&] { return setIntNode(nHeight, height); });
+			}
+
+			/**
+			* ZT̐؂ö(ROI)̎擾
+			* @return cv::Rect ؂ö
+			*/
+			cv::Rect getRoi() {
+				return cv::Rect((int)nOffsetX.get(0), (int)nOffsetY.get(0), (int)nWidth.get(0), (int)nHeight.get(0));
+			}
+
+			/**
+			* ZT̐؂ö(ROI)̐ݒ(T|[gȂJ)
+			* 傫ς炸ItZbg擾ɏJł,擾~߂Ɉړ
+			* ȊO͈x~,obt@ĊmۂčĊJ
+			* @param[in] roi ؂ö
+			* @return bool ݒύXł
+			*/
+			bool setRoi(cv::Rect roi) {
+				try {
+					if (capturing && getRoi().size() == roi.size() && nOffsetX.isWriteable() && nOffsetY.isWriteable()) {
+						bool canMove = setIntNode(nOffsetX, roi.x);
+						canMove &= setIntNode(nOffsetY, roi.y);
+						return canMove;
+					}
+				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
+
+				return reconfigure([&] {
+					//ƍ̏̓ItZbgɈˑ邽,ɃItZbg0ɖ߂
+					setIntNode(nOffsetX, 0);
+					setIntNode(nOffsetY, 0);
+					bool canSet = setIntNode(nWidth, roi.width);
+					canSet &= setIntNode(nHeight, roi.height);
+					canSet &= setIntNode(nOffsetX, roi.x) || roi.x == 0;
+					canSet &= setIntNode(nOffsetY, roi.y) || roi.y == 0;
+					return canSet;
+				});
+			}
+
+			/**
+			* rjO̎擾
+			* @return cv::Size ,c̃rjO
+			*/
+			cv::Size getBinning() {
+				return cv::Size((int)nBinningHorizontal.get(1), (int)nBinningVertical.get(1));
+			}
+
+			/**
+			* rjO̐ݒ(T|[gȂJ)
+			* x~,obt@ĊmۂčĊJ
+			* @param[in] horizontal ̃rjO
+			* @param[in] vertical c̃rjO
+			* @return bool ݒύXł
+			*/
+			bool setBinning(int horizontal, int vertical) {
+				return reconfigure([&] {
+					bool canSet = setIntNode(nBinningHorizontal, horizontal);
+					canSet &= setIntNode(nBinningVertical, vertical);
+					return canSet;
+				});
+			}
+
+			/**
+			* Ԉ̎擾
+			* @return cv::Size ,c̊Ԉ
+			*/
+			cv::Size getDecimation() {
+				return cv::Size((int)nDecimationHorizontal.get(1), (int)nDecimationVertical.get(1));
+			}
+
+			/**
+			* Ԉ̐ݒ(T|[gȂJ)
+			* x~,obt@ĊmۂčĊJ
+			* @param[in] horizontal ̊Ԉ
+			* @param[in] vertical c̊Ԉ
+			* @return bool ݒύXł
+			*/
+			bool setDecimation(int horizontal, int vertical) {
+				return reconfigure([&] {
+					bool canSet = setIntNode(nDecimationHorizontal, horizontal);
+					canSet &= setIntNode(nDecimationVertical, vertical);
+					return canSet;
+				});
+			}
+
+			/**
+			* gK[h̐ݒ
+			* @param[in] enable trueȂgKƂɎBe,falseȂt[
+			* @return bool ݒł
+			*/
+			bool setTriggerMode(bool enable) {
+				return writeTrigger([&] {
+					pTriggerMode->SetString(enable ? "On" : "Off");
+					bTriggerMode = enable;
+				});
+			}
+
+			/**
+			* gK[h̎擾
+			* @return bool gKƂɎBe邩
+			*/
+			inline bool getTriggerMode() {
+				return bTriggerMode;
+			}
+
+			/**
+			* gK͂̐ݒ
+			* @param[in] source "Software", "Line0"Ȃ(GenICamTriggerSource̒l)
+			* @return bool ݒł
+			*/
+			bool setTriggerSource(BGAPI2::String source) {
+				if (pTriggerSource == NULL)return false;
+				return writeTrigger([&] {
+					pTriggerSource->SetString(source);
+					sTriggerSource = source;
+				});
+			}
 
-				bo_int64 heightvalue = (height / iImageHeightInc) * iImageHeightInc;
+			/**
+			* gK͂̎擾
+			* @return BGAPI2::String gK
+			*/
+			inline BGAPI2::String getTriggerSource() {
+				if (sTriggerSource == "" && pTriggerSource != NULL)sTriggerSource = pTriggerSource->GetString();
+				return sTriggerSource;
+			}
 
-				if (heightvalue < iImageHeightMin) { heightvalue = iImageHeightMin; }
-				if (heightvalue > iImageHeightMax) { heightvalue = iImageHeightMax; }
+			/**
+			* gǨo̐ݒ
+			* @param[in] activation "RisingEdge", "FallingEdge"Ȃ(GenICamTriggerActivation̒l)
+			* @return bool ݒł
+			*/
+			bool setTriggerActivation(BGAPI2::String activation) {
+				if (pTriggerActivation == NULL)return false;
+				return writeTrigger([&] {
+					pTriggerActivation->SetString(activation);
+					sTriggerActivation = activation;
+				});
+			}
 
-				pDevice->GetRemoteNode("Height")->SetInt(heightvalue);
+			/**
+			* \tgEFAgK̎s
+			* (o[XggǨJԂőpĂꍇ̓o[Xgs)
+			* @return bool sł
+			*/
+			bool executeSoftwareTrigger() {
+				if (pTriggerSoftware == NULL)return false;
+				try {
+					int n = burstEmulated ? burstCount : 1;
+					for (int i = 0; i < n; i++) {
+						pTriggerSoftware->Execute();
+					}
+				} catch (BGAPI2::Exceptions::IException& ex) { return false; }
 				return true;
 			}
 
+			/**
+			* 1̃gKŎBe閇̐ݒ
+			* JAcquisitionBurstFrameCountɑΉĂFrameBurstStartgKg,
+			* ΉĂȂ΃\tgEFAgǨJԂőp(n[hEFAgKł͑płȂ)
+			* obt@̓o[XgŜ󂯎悤+1ȏɑ₷
+			* @param[in] frames 
+			* @return bool ݒł
+			*/
+			bool setBurst(int frames) {
+				if (frames < 1)return false;
+
+				bool hardware = pBurstFrameCount != NULL && pTriggerSelector != NULL &&
+					pTriggerSelector->GetEnumNodeList()->GetNodePresent("FrameBurstStart");
+				if (!hardware && frames > 1 && getTriggerSource() != "Software")return false;
+
+				buffer_pool_config config = stream.poolConfig;
+				if (config.count < frames + 1)config.count = frames + 1;
+
+				return reconfigure([&] {
+					stream.poolConfig = config;
+					burstCount = frames;
+					burstEmulated = !hardware && frames > 1;
+					if (!hardware)return true;
+
+					//gȂȂZN^̃gK͎~߂Ă؂ւ
+					BGAPI2::String selector = frames > 1 ? "FrameBurstStart" : "FrameStart";
+					if (selector != sTriggerSelector) {
+						getTriggerSource();
+						if (sTriggerActivation == "" && pTriggerActivation != NULL)sTriggerActivation = pTriggerActivation->GetString();
+						pTriggerMode->SetString("Off");
+						sTriggerSelector = selector;
+						applyTrigger();
+					}
+					pBurstFrameCount->SetInt(frames);
+					return true;
+				});
+			}
+
+			/**
+			* 1̃gKŎBe閇̎擾
+			* @return int 
+			*/
+			inline int getBurst() {
+				return burstCount;
+			}
+
+			/**
+			* o[XgBe摜܂Ƃ߂ēǂݍ
+			* batchg񂹂,vfςȂ摜̗̈ėp
+			* @param[in,out] batch o͐(vf̓o[Xgɑ)
+			* @return bool o[XgŜǂݍ߂(batch.countɓǂݍ߂)
+			*/
+			bool readBurst(frame_batch& batch) {
+				batch.reserve(burstCount);
+				batch.count = 0;
+				for (int i = 0; i < burstCount; i++) {
+					if (!read(batch.frames[i], batch.infos[i]))break;
+					batch.count++;
+				}
+				return batch.count == (size_t)burstCount;
+			}
+
 			/**
 			* J̃f擾
 			* @return BGAPI2::String J̃f
@@ -714,7 +3789,31 @@ namespace baumer {
 		*/
 		std::vector<baumer_device> cameras;
 	public:
+		/**
+		* JJƂ̐ݒ
+		*/
+		struct open_options {
+			std::vector<std::string> serialNumbers;		//JJ̃VAio[(ȂS)
+			bool parallel = true;						//C^[tF[X,foCXƂɕɊJ
+			int refreshTimeout = 100;					//C^[tF[X,foCX̑҂[msec]
+			std::function<void(baumer_device&)> onReady;	//J̏ݒ肪I邽тɌĂ΂(Ăяo͒񉻂)
+			std::string configCache;					//ݒLbṼt@C(ȂgȂ)
+#ifdef RSDLAB_BAUMER_USE_SIMULATOR
+			std::vector<std::string> playbackFiles;		//startRecordingŋL^t@C(w肷ƃJ̑ɍĐ)
+			playback_mode playback = playback_mode::realtime;	//Đ̑x
+			double playbackFps = 30;					//playback_mode::fixed_ratẽt[[g
+			bool playbackLoop = true;					//܂ōĐ擪ɖ߂邩
+#endif
+		};
+
 		VideoCapture();
+
+		/**
+		* ݒw肵ăJJ
+		* Əݒ̓C^[tF[X,foCXƂɕɍs,J̏Ԃ͌ɑ
+		* @param[in] options ݒ
+		*/
+		explicit VideoCapture(const open_options& options);
 		~VideoCapture();
 		/**
 		* J摜擾Jn
@@ -728,6 +3827,113 @@ namespace baumer {
 		*/
 		bool stop();
 
+		/**
+		* ׂẴJŐp̎擾XbhJn
+		* @param[in] capacity O̗e
+		* @param[in] policy OꂽƂ̓
+		* @param[in] pool SJŋLϊXbhv[(nullptrȂJƂ̎擾Xbhŕϊ)
+		* @return bool ׂẴJŊJnł
+		*/
+		bool startGrabbing(int capacity = 4, overflow_policy policy = overflow_policy::drop_oldest, std::shared_ptr<convert_pool> pool = nullptr);
+
+		/**
+		* SJ瓯ɎBeꂽ摜̑gǂݍ
+		* 擾XbhĂȂJ͎IɊJn邽,JƂ̎擾͕ɍs
+		* ̑gÂ摜͎̂,gɓȂV摜͎Ɏz
+		* (^CX^vPTPȂǂŃJԂ̎ĂO)
+		* @param[out] frames J̉摜o
+		* @param[in] tolerance gƂ݂Ȃ^CX^v̍(J̃^CX^vP, ʏnsec)
+		* @param[in] timeout g܂ő҂ő厞[msec]
+		* @return bool g
+		*/
+		bool readSynchronized(std::vector<cv::Mat>& frames, bo_uint64 tolerance, int timeout = 1000);
+
+		/**
+		* SJ瓯ɎBeꂽ摜̑g^f[^tœǂݍ
+		* @param[out] frames J̉摜o
+		* @param[out] infos J̃^f[^
+		* @param[in] tolerance gƂ݂Ȃ^CX^v̍(J̃^CX^vP, ʏnsec)
+		* @param[in] timeout g܂ő҂ő厞[msec]
+		* @return bool g
+		*/
+		bool readSynchronized(std::vector<cv::Mat>& frames, std::vector<frame_info>& infos, bo_uint64 tolerance, int timeout = 1000);
+
+		/**
+		* ׂẴJ̃gK[h̐ݒ
+		* @param[in] enable trueȂgKƂɎBe,falseȂt[
+		* @param[in] source gK(ȂJ̒l̂܂)
+		* @return bool ׂẴJŐݒł
+		*/
+		bool setTriggerMode(bool enable, BGAPI2::String source = "Software");
+
+		/**
+		* ׂẴJ֓Ƀ\tgEFAgK𑗂
+		* JƂ̃Xbhҋ@Ă,ĂɎs邱ƂŃJԂ̂}
+		* (Xbh͍ŏ̌Ăяoō,ȍ~͎g. }ꍇ̓n[hEFAgKg)
+		* @return bool ׂẴJŎsł
+		*/
+		bool trigger();
+
+		/**
+		* ǂݍ݂̓v̎擾
+		* @return sync_stats v
+		*/
+		inline sync_stats getSyncStats() {
+			return syncStats;
+		}
+
+		/**
+		* SJ̓vPrometheus̃eLXg`Ŏ擾
+		* (Jserialxŋʂ)
+		* @return std::string v
+		*/
+		std::string getStatsText();
+
+		/**
+		* ݂̐ݒݒLbV֕ۑ
+		* (open_options::configCachew肵ĊJꍇ̂. ̃J̐ݒ͎c)
+		* @return bool ۑł
+		*/
+		bool saveConfigCache();
+
+		/**
+		* v̒Iȃt@Co͂̊Jn
+		* ꎞt@CɏĂu邽,node_exportertextfile collectorȂǂr̓e͓ǂ܂Ȃ
+		* @param[in] path o͐
+		* @param[in] intervalMs o͊Ԋu[msec]
+		* @return bool Jnł
+		*/
+		bool startStatsExporter(const std::string& path, int intervalMs = 1000);
+
+		/**
+		* ṽt@Co͂̒~
+		*/
+		void stopStatsExporter();
+
+		/**
+		* ̒ʒm󂯎֐
+		* (ĎXbhĂ΂邽,J̑͂Ȃ)
+		*/
+		typedef std::function<void(const std::string& serialNumber, device_event event)> device_event_handler;
+
+		/**
+		* J̔̊Ď̊Jn
+		* ԊuŃfoCXꗗXV,ꂽJ͈ȍ~read()Ɏs
+		* VAio[̃J߂ĎXbhŊJ,ݒ(I,QC,ROI,
+		* obt@,gK,IoȂ)ƎBeȂ擾Xbh܂Ŗ߂Ă,read()ōւ
+		* ̃J̓ǂݍ݂͎~߂Ȃ
+		* (ĂԂ͊YJread()ȊȎȂ. JĂȂJ͒ʒm邾ŊJȂ)
+		* @param[in] intervalMs mF̊Ԋu[msec]
+		* @param[in] handler ̒ʒm(ȂʒmȂ)
+		* @return bool Jnł
+		*/
+		bool startDeviceMonitor(int intervalMs = 1000, device_event_handler handler = nullptr);
+
+		/**
+		* ̊Ď̒~
+		*/
+		void stopDeviceMonitor();
+
 		/**
 		* J擾
 		* @return int ڑꂽJ̐
@@ -760,7 +3966,35 @@ namespace baumer {
 
 	private:
 		
-		bool openSystem();
+		bool openSystem(const open_options& options);
+
+		std::vector<baumer_device::grabbed_frame> syncPending;
+		std::vector<bool> syncHas;
+		sync_stats syncStats;
+		unsigned long long syncSkewSum = 0;
+
+		std::string configCachePath;
+		std::map<std::string, device_config> configCache;
+
+		std::unique_ptr<trigger_gate> triggerGate;
+
+		std::thread exporter;
+		std::atomic<bool> exporting{ false };
+		std::mutex exporterMutex;
+		std::condition_variable exporterCond;
+
+		/**
+		* foCXꗗXV,𔽉f(ĎXbhŌĂ)
+		* @param[in,out] arrived ʒmς݂̊JĂȂJ
+		* @param[in] handler ̒ʒm
+		*/
+		void pollDevices(std::vector<std::string>& arrived, const device_event_handler& handler);
+
+		std::vector<std::shared_ptr<baumer_device::device_link>> monitorLinks;
+		std::thread monitor;
+		std::atomic<bool> monitoring{ false };
+		std::mutex monitorMutex;
+		std::condition_variable monitorCond;
 	};
 }
 
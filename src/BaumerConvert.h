@@ -0,0 +1,1113 @@
+#ifndef RSDLAB_BAUMER_CONVERT
+#define RSDLAB_BAUMER_CONVERT
+
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#if defined(__AVX2__)
+#define RSDLAB_BAUMER_AVX2
+#define RSDLAB_BAUMER_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RSDLAB_BAUMER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RSDLAB_BAUMER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace baumer {
+	/**
+	* ΉĂsNZtH[}bg
+	*/
+	enum class pixel_format {
+		Unknown,
+		BGR8,
+		BayerRG8,
+		BayerGB8,
+		Mono8,
+		Mono16,
+		Mono12,
+		BayerRG12,
+		BayerGB12,
+		Mono10,
+		BayerRG10,
+		BayerGB10,
+		BGR16,
+		BGR12,
+		BGR10,
+		Mono12p,
+		Mono12Packed,
+		Mono10p,
+		BayerGR8,
+		BayerBG8,
+		BayerGR12,
+		BayerBG12,
+		BayerGR10,
+		BayerBG10
+	};
+
+	/**
+	* sNZtH[}bg̕ϊ\
+	*/
+	struct pixel_format_name {
+		const char* name;
+		pixel_format format;
+	};
+
+	static const pixel_format_name pixelFormatNames[] = {
+		{ "BGR8", pixel_format::BGR8 },
+		{ "BGR8Packed", pixel_format::BGR8 },
+		{ "BayerRG8", pixel_format::BayerRG8 },
+		{ "BayerGB8", pixel_format::BayerGB8 },
+		{ "Mono8", pixel_format::Mono8 },
+		{ "Mono16", pixel_format::Mono16 },
+		{ "Mono12", pixel_format::Mono12 },
+		{ "BayerRG12", pixel_format::BayerRG12 },
+		{ "BayerGB12", pixel_format::BayerGB12 },
+		{ "Mono10", pixel_format::Mono10 },
+		{ "BayerRG10", pixel_format::BayerRG10 },
+		{ "BayerGB10", pixel_format::BayerGB10 },
+		{ "BGR16", pixel_format::BGR16 },
+		{ "BGR12", pixel_format::BGR12 },
+		{ "BGR10", pixel_format::BGR10 },
+		{ "Mono12p", pixel_format::Mono12p },
+		{ "Mono12Packed", pixel_format::Mono12Packed },
+		{ "Mono10p", pixel_format::Mono10p },
+		{ "BayerGR8", pixel_format::BayerGR8 },
+		{ "BayerBG8", pixel_format::BayerBG8 },
+		{ "BayerGR12", pixel_format::BayerGR12 },
+		{ "BayerBG12", pixel_format::BayerBG12 },
+		{ "BayerGR10", pixel_format::BayerGR10 },
+		{ "BayerBG10", pixel_format::BayerBG10 }
+	};
+
+	/**
+	* sNZtH[}bg񋓒lւ̕ϊ
+	* @param[in] name GenICam̃sNZtH[}bg
+	* @return pixel_format sNZtH[}bg(ΉȂUnknown)
+	*/
+	inline pixel_format toPixelFormat(const char* name) {
+		for (const auto& entry : pixelFormatNames) {
+			if (strcmp(entry.name, name) == 0)return entry.format;
+		}
+		return pixel_format::Unknown;
+	}
+
+	/**
+	* 񋓒lsNZtH[}bgւ̕ϊ
+	* @param[in] format sNZtH[}bg
+	* @return const char* GenICam̃sNZtH[}bg
+	*/
+	inline const char* toPixelFormatName(pixel_format format) {
+		for (const auto& entry : pixelFormatNames) {
+			if (entry.format == format)return entry.name;
+		}
+		return "Unknown";
+	}
+
+	/**
+	* ϊỎ摜(hCõobt@)
+	*/
+	struct raw_frame {
+		void* data = NULL;
+		int width = 0;
+		int height = 0;
+		pixel_format format = pixel_format::Unknown;
+	};
+
+	/**
+	* Bayer̃fUCN@
+	*/
+	enum class demosaic_method {
+		none,		//fUCNBayer̂܂ܕԂ
+		nearest,	//2x2Ƃ̍ŋߖT(ő)
+		bilinear,	//o`(OpenCV̕W)
+		vng,		//VNG(8bit̂, 16bitłbilinearɂȂ)
+		edge_aware	//GbWl
+	};
+
+	/**
+	* Bayer̕(2x2̕)
+	*/
+	enum class bayer_pattern {
+		RG,
+		GB,
+		GR,
+		BG
+	};
+
+	/**
+	* ǂݍމ摜̌^Ƒ傫̎w
+	* w肪΃sNZtH[}bgɉ^̂܂ܕԂ
+	*/
+	struct output_spec {
+		int type = -1;			//cv::Mať^(CV_8UC1/CV_8UC3/CV_16UC1/CV_16UC3. -1ȂsNZtH[}bĝ܂)
+		double scale = 1.0;		//k(0傫1ȉ. 0.5ȉȂBayer2x2Ƃɂ܂Ƃ߂ăfUCN)
+
+		output_spec() {}
+		output_spec(int type, double scale = 1.0) : type(type), scale(scale) {}
+
+		/**
+		* ^傫̎w肪邩
+		* @return bool w肪邩
+		*/
+		inline bool active() const {
+			return type >= 0 || scale != 1.0;
+		}
+	};
+
+	/**
+	* ϊ̐ݒ
+	*/
+	struct convert_options {
+		demosaic_method demosaic = demosaic_method::bilinear;	//fUCN@
+		output_spec output;										//o͂̌^Ƒ傫
+	};
+
+	/**
+	* ϊ֐
+	* @param[in] src ϊỎ摜
+	* @param[out] dst 摜o
+	* @param[in] opt ϊ̐ݒ
+	*/
+	typedef void(*converter)(const raw_frame& src, cv::Mat& dst, const convert_options& opt);
+
+	/**
+	* 16bit摜̍Vtg(in-placeł)
+	* AVX2/SSE2/NEONg΃xNg,c̓XJ[ŏ
+	* @param[in] src 
+	* @param[out] dst o(srcƓł悢)
+	* @param[in] n vf
+	* @param[in] shift Vtg[bit]
+	*/
+	inline void shiftLeft16(const ushort* src, ushort* dst, size_t n, int shift) {
+		if (shift == 0) {
+			if (src != dst)memcpy(dst, src, n * sizeof(ushort));
+			return;
+		}
+
+		size_t i = 0;
+#if defined(RSDLAB_BAUMER_AVX2)
+		__m128i count = _mm_cvtsi32_si128(shift);
+		for (; i + 16 <= n; i += 16) {
+			__m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm256_sll_epi16(v, count));
+		}
+#endif
+#if defined(RSDLAB_BAUMER_SSE2)
+		__m128i count128 = _mm_cvtsi32_si128(shift);
+		for (; i + 8 <= n; i += 8) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_sll_epi16(v, count128));
+		}
+#elif defined(RSDLAB_BAUMER_NEON)
+		int16x8_t count = vdupq_n_s16((short)shift);
+		for (; i + 8 <= n; i += 8) {
+			vst1q_u16(dst + i, vshlq_u16(vld1q_u16(src + i), count));
+		}
+#endif
+		for (; i < n; i++) {
+			dst[i] = (ushort)(src[i] << shift);
+		}
+	}
+
+	/**
+	* Mono12p(GenICam PFNC, LSBl߂)̓WJƃVtg
+	* 2f3byteɋl߂`
+	* @param[in] src 
+	* @param[out] dst o
+	* @param[in] n f
+	* @param[in] shift WJ̃Vtg[bit]
+	*/
+	inline void unpackMono12p(const uchar* src, ushort* dst, size_t n, int shift) {
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2, src += 3) {
+			dst[i] = (ushort)((src[0] | ((src[1] & 0x0F) << 8)) << shift);
+			dst[i + 1] = (ushort)(((src[1] >> 4) | (src[2] << 4)) << shift);
+		}
+		if (i < n) {
+			dst[i] = (ushort)((src[0] | ((src[1] & 0x0F) << 8)) << shift);
+		}
+	}
+
+	/**
+	* Mono12Packed(GigE Vision`)̓WJƃVtg
+	* 2f3byteɋl,byteɗf̉4bit`
+	* @param[in] src 
+	* @param[out] dst o
+	* @param[in] n f
+	* @param[in] shift WJ̃Vtg[bit]
+	*/
+	inline void unpackMono12Packed(const uchar* src, ushort* dst, size_t n, int shift) {
+		size_t i = 0;
+		for (; i + 2 <= n; i += 2, src += 3) {
+			dst[i] = (ushort)(((src[0] << 4) | (src[1] & 0x0F)) << shift);
+			dst[i + 1] = (ushort)(((src[2] << 4) | (src[1] >> 4)) << shift);
+		}
+		if (i < n) {
+			dst[i] = (ushort)(((src[0] << 4) | (src[1] & 0x0F)) << shift);
+		}
+	}
+
+	/**
+	* Mono10p(GenICam PFNC, LSBl߂)̓WJƃVtg
+	* 4f5byteɋl߂`
+	* @param[in] src 
+	* @param[out] dst o
+	* @param[in] n f
+	* @param[in] shift WJ̃Vtg[bit]
+	*/
+	inline void unpackMono10p(const uchar* src, ushort* dst, size_t n, int shift) {
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4, src += 5) {
+			dst[i] = (ushort)((src[0] | ((src[1] & 0x03) << 8)) << shift);
+			dst[i + 1] = (ushort)(((src[1] >> 2) | ((src[2] & 0x0F) << 6)) << shift);
+			dst[i + 2] = (ushort)(((src[2] >> 4) | ((src[3] & 0x3F) << 4)) << shift);
+			dst[i + 3] = (ushort)(((src[3] >> 6) | (src[4] << 2)) << shift);
+		}
+		//[̓rbgƂēǂ
+		size_t bit = 0;
+		for (; i < n; i++, bit += 10) {
+			size_t byte = bit >> 3;
+			int offset = (int)(bit & 7);
+			int value = ((src[byte] | (src[byte + 1] << 8)) >> offset) & 0x3FF;
+			dst[i] = (ushort)(value << shift);
+		}
+	}
+
+	/**
+	* o͐̏
+	* o͐悪hCõobt@QƂĂꍇ͏܂ɐ؂藣Ămۂ
+	* (TCY,^łΑÖ̗ėp)
+	* @param[out] dst o͐
+	* @param[in] rows s
+	* @param[in] cols 
+	* @param[in] type ^
+	*/
+	inline void createOutput(cv::Mat& dst, int rows, int cols, int type) {
+		if (dst.u == NULL || (dst.u->flags & cv::UMatData::USER_ALLOCATED)) {
+			dst.release();
+		}
+		dst.create(rows, cols, type);
+	}
+
+	/**
+	* OpenCVBayerϊR[h̎擾
+	* (OpenCV2s2ڂ̕тŖĂ邽,GenICam̖OƂ͂)
+	* @param[in] pattern Bayer̕
+	* @param[in] method fUCN@(bilinear/vng/edge_aware)
+	* @param[in] depth ͂̐[x(CV_8U/CV_16U)
+	* @return int ϊR[h
+	*/
+	inline int getBayerCode(bayer_pattern pattern, demosaic_method method, int depth) {
+		static const int codes[4][3] = {
+			{ cv::COLOR_BayerBG2BGR, cv::COLOR_BayerBG2BGR_VNG, cv::COLOR_BayerBG2BGR_EA },
+			{ cv::COLOR_BayerGR2BGR, cv::COLOR_BayerGR2BGR_VNG, cv::COLOR_BayerGR2BGR_EA },
+			{ cv::COLOR_BayerGB2BGR, cv::COLOR_BayerGB2BGR_VNG, cv::COLOR_BayerGB2BGR_EA },
+			{ cv::COLOR_BayerRG2BGR, cv::COLOR_BayerRG2BGR_VNG, cv::COLOR_BayerRG2BGR_EA }
+		};
+		int m = 0;
+		if (method == demosaic_method::vng && depth == CV_8U) {
+			m = 1;
+		} else if (method == demosaic_method::edge_aware) {
+			m = 2;
+		}
+		return codes[(int)pattern][m];
+	}
+
+	/**
+	* 2x2Ƃ̍ŋߖTfUCN
+	* 2s̑тɕĕɏ
+	* @param[in] src Bayer摜(CV_8UC1/CV_16UC1)
+	* @param[out] dst BGR摜(mۍς)
+	* @param[in] pattern Bayer̕
+	*/
+	template<typename T>
+	inline void demosaicNearest(const cv::Mat& src, cv::Mat& dst, bayer_pattern pattern) {
+		const int rx = (pattern == bayer_pattern::RG || pattern == bayer_pattern::GB) ? 0 : 1;
+		const int ry = (pattern == bayer_pattern::RG || pattern == bayer_pattern::GR) ? 0 : 1;
+		const int blocksX = src.cols / 2;
+
+		cv::parallel_for_(cv::Range(0, src.rows / 2), [&](const cv::Range& range) {
+			for (int by = range.start; by < range.end; by++) {
+				const T* s0 = src.ptr<T>(by * 2);
+				const T* s1 = src.ptr<T>(by * 2 + 1);
+				const T* sr = ry == 0 ? s0 : s1;
+				const T* sb = ry == 0 ? s1 : s0;
+				T* d0 = dst.ptr<T>(by * 2);
+				T* d1 = dst.ptr<T>(by * 2 + 1);
+
+				for (int bx = 0; bx < blocksX; bx++) {
+					int x = bx * 2;
+					T r = sr[x + rx];
+					T b = sb[x + (rx ^ 1)];
+					T g = (T)((sr[x + (rx ^ 1)] + sb[x + rx] + 1) >> 1);
+					T* p[4] = { d0 + x * 3, d0 + x * 3 + 3, d1 + x * 3, d1 + x * 3 + 3 };
+					for (int k = 0; k < 4; k++) {
+						p[k][0] = b;
+						p[k][1] = g;
+						p[k][2] = r;
+					}
+				}
+				if (src.cols & 1) {
+					memcpy(d0 + (src.cols - 1) * 3, d0 + (src.cols - 2) * 3, 3 * sizeof(T));
+					memcpy(d1 + (src.cols - 1) * 3, d1 + (src.cols - 2) * 3, 3 * sizeof(T));
+				}
+			}
+		});
+		if (src.rows & 1) {
+			memcpy(dst.ptr<T>(src.rows - 1), dst.ptr<T>(src.rows - 2), dst.cols * 3 * sizeof(T));
+		}
+	}
+
+	/**
+	* тɕĕcvtColorŃfUCN
+	* (OpenCVŕ񉻂ȂVNG傫ȃZTŎgꍇp)
+	* т̋E͏㉺ɗ]ȍs܂߂ĕϊ,pڂoȂ悤ɂ
+	* @param[in] src Bayer摜
+	* @param[out] dst BGR摜(mۍς)
+	* @param[in] code ϊR[h
+	*/
+	inline void demosaicStriped(const cv::Mat& src, cv::Mat& dst, int code) {
+		const int border = 4;
+		int stripes = std::max(1, std::min(cv::getNumThreads(), src.rows / 64));
+		int stripeRows = ((src.rows + stripes - 1) / stripes + 1) & ~1;
+
+		cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+			thread_local cv::Mat scratch;
+			for (int i = range.start; i < range.end; i++) {
+				int y0 = i * stripeRows;
+				int y1 = std::min(src.rows, y0 + stripeRows);
+				if (y0 >= y1)continue;
+				int s0 = std::max(0, y0 - border);
+				int s1 = std::min(src.rows, y1 + border);
+
+				cv::cvtColor(src.rowRange(s0, s1), scratch, code);
+				cv::Mat dstRows = dst.rowRange(y0, y1);
+				scratch.rowRange(y0 - s0, y1 - s0).copyTo(dstRows);
+			}
+		});
+	}
+
+	/**
+	* fUCN
+	* @param[in] src Bayer摜(CV_8UC1/CV_16UC1)
+	* @param[out] dst BGR摜(TCY,^łΑÖ̗ėp)
+	* @param[in] pattern Bayer̕
+	* @param[in] method fUCN@
+	*/
+	inline void demosaic(const cv::Mat& src, cv::Mat& dst, bayer_pattern pattern, demosaic_method method) {
+		createOutput(dst, src.rows, src.cols, CV_MAKETYPE(src.depth(), 3));
+		if (method == demosaic_method::nearest) {
+			if (src.depth() == CV_8U) {
+				demosaicNearest<uchar>(src, dst, pattern);
+			} else {
+				demosaicNearest<ushort>(src, dst, pattern);
+			}
+			return;
+		}
+
+		int code = getBayerCode(pattern, method, src.depth());
+		if (method == demosaic_method::vng && src.depth() == CV_8U) {
+			demosaicStriped(src, dst, code);
+		} else {
+			cv::cvtColor(src, dst, code); //to BGR
+		}
+	}
+
+	/**
+	* sNZtH[}bgƂ̕ϊ
+	* Ή̃tH[}bg͉o͂Ȃ
+	*/
+	template<pixel_format F>
+	struct format_converter {
+		static void convert(const raw_frame&, cv::Mat& dst, const convert_options&) {
+			dst.release();
+		}
+	};
+
+	/**
+	* ϊ̗vȂ`̃Rs[
+	* obt@͕ϊシɍăL[邽ߎQƂ͕Ԃ,ėp\ȏo͐֎ʂ
+	* (Rs[Ȃꍇ̓[Rs[ǂݍ݂g)
+	*/
+	template<int Type>
+	struct direct_converter {
+		static void convert(const raw_frame& src, cv::Mat& dst, const convert_options&) {
+			createOutput(dst, src.height, src.width, Type);
+			cv::Mat(src.height, src.width, Type, src.data).copyTo(dst);
+		}
+	};
+
+	/**
+	* 16bitɑVtgϊ(Mono10/Mono12/BGR10/BGR12/BGR16)
+	* hCõobt@͏,ėp\ȏo͐ɏ
+	*/
+	template<int Type, int Shift>
+	struct shift_converter {
+		static void convert(const raw_frame& src, cv::Mat& dst, const convert_options&) {
+			createOutput(dst, src.height, src.width, Type);
+			shiftLeft16((const ushort*)src.data, dst.ptr<ushort>(), dst.total() * dst.channels(), Shift);
+		}
+	};
+
+	/**
+	* pbNꂽMono`̓WJƃVtgxɍsϊ
+	*/
+	template<void(*Unpack)(const uchar*, ushort*, size_t, int), int Shift>
+	struct packed_converter {
+		static void convert(const raw_frame& src, cv::Mat& dst, const convert_options&) {
+			createOutput(dst, src.height, src.width, CV_16UC1);
+			Unpack((const uchar*)src.data, dst.ptr<ushort>(), dst.total(), Shift);
+		}
+	};
+
+	/**
+	* BayerBGRւ̕ϊ
+	* 10/12bit̓fUCN̏o͂ɑ΂ăVtg
+	*/
+	template<bayer_pattern Pattern, int Depth, int Shift>
+	struct bayer_converter {
+		static void convert(const raw_frame& src, cv::Mat& dst, const convert_options& opt) {
+			cv::Mat imOriginal(src.height, src.width, Depth == CV_8U ? CV_8UC1 : CV_16UC1, src.data);
+			if (opt.demosaic == demosaic_method::none) {
+				if (Depth == CV_8U) {
+					createOutput(dst, src.height, src.width, CV_8UC1);
+					imOriginal.copyTo(dst);
+				} else {
+					createOutput(dst, src.height, src.width, CV_16UC1);
+					shiftLeft16(imOriginal.ptr<ushort>(), dst.ptr<ushort>(), dst.total(), Shift);
+				}
+				return;
+			}
+
+			demosaic(imOriginal, dst, Pattern, opt.demosaic);
+			if (Shift > 0)shiftLeft16(dst.ptr<ushort>(), dst.ptr<ushort>(), dst.total() * 3, Shift);
+		}
+	};
+
+	template<> struct format_converter<pixel_format::BGR8> : direct_converter<CV_8UC3> {};
+	template<> struct format_converter<pixel_format::Mono8> : direct_converter<CV_8UC1> {};
+	template<> struct format_converter<pixel_format::Mono16> : direct_converter<CV_16UC1> {};
+	template<> struct format_converter<pixel_format::BayerRG8> : bayer_converter<bayer_pattern::RG, CV_8U, 0> {};
+	template<> struct format_converter<pixel_format::BayerGB8> : bayer_converter<bayer_pattern::GB, CV_8U, 0> {};
+	template<> struct format_converter<pixel_format::BayerGR8> : bayer_converter<bayer_pattern::GR, CV_8U, 0> {};
+	template<> struct format_converter<pixel_format::BayerBG8> : bayer_converter<bayer_pattern::BG, CV_8U, 0> {};
+	template<> struct format_converter<pixel_format::Mono12> : shift_converter<CV_16UC1, 4> {};
+	template<> struct format_converter<pixel_format::BayerRG12> : bayer_converter<bayer_pattern::RG, CV_16U, 4> {};
+	template<> struct format_converter<pixel_format::BayerGB12> : bayer_converter<bayer_pattern::GB, CV_16U, 4> {};
+	template<> struct format_converter<pixel_format::BayerGR12> : bayer_converter<bayer_pattern::GR, CV_16U, 4> {};
+	template<> struct format_converter<pixel_format::BayerBG12> : bayer_converter<bayer_pattern::BG, CV_16U, 4> {};
+	template<> struct format_converter<pixel_format::Mono10> : shift_converter<CV_16UC1, 6> {};
+	template<> struct format_converter<pixel_format::BayerRG10> : bayer_converter<bayer_pattern::RG, CV_16U, 6> {};
+	template<> struct format_converter<pixel_format::BayerGB10> : bayer_converter<bayer_pattern::GB, CV_16U, 6> {};
+	template<> struct format_converter<pixel_format::BayerGR10> : bayer_converter<bayer_pattern::GR, CV_16U, 6> {};
+	template<> struct format_converter<pixel_format::BayerBG10> : bayer_converter<bayer_pattern::BG, CV_16U, 6> {};
+	template<> struct format_converter<pixel_format::BGR16> : shift_converter<CV_16UC3, 0> {};
+	template<> struct format_converter<pixel_format::BGR12> : shift_converter<CV_16UC3, 4> {};
+	template<> struct format_converter<pixel_format::BGR10> : shift_converter<CV_16UC3, 6> {};
+	template<> struct format_converter<pixel_format::Mono12p> : packed_converter<&unpackMono12p, 4> {};
+	template<> struct format_converter<pixel_format::Mono12Packed> : packed_converter<&unpackMono12Packed, 4> {};
+	template<> struct format_converter<pixel_format::Mono10p> : packed_converter<&unpackMono10p, 6> {};
+
+	/**
+	* rbg[xςȂϊ(̃rbg[x̂܂܈ꍇ)
+	*/
+	template<pixel_format F>
+	struct native_converter : format_converter<F> {};
+
+	template<> struct native_converter<pixel_format::Mono12> : direct_converter<CV_16UC1> {};
+	template<> struct native_converter<pixel_format::BayerRG12> : bayer_converter<bayer_pattern::RG, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BayerGB12> : bayer_converter<bayer_pattern::GB, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BayerGR12> : bayer_converter<bayer_pattern::GR, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BayerBG12> : bayer_converter<bayer_pattern::BG, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::Mono10> : direct_converter<CV_16UC1> {};
+	template<> struct native_converter<pixel_format::BayerRG10> : bayer_converter<bayer_pattern::RG, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BayerGB10> : bayer_converter<bayer_pattern::GB, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BayerGR10> : bayer_converter<bayer_pattern::GR, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BayerBG10> : bayer_converter<bayer_pattern::BG, CV_16U, 0> {};
+	template<> struct native_converter<pixel_format::BGR12> : shift_converter<CV_16UC3, 0> {};
+	template<> struct native_converter<pixel_format::BGR10> : shift_converter<CV_16UC3, 0> {};
+	template<> struct native_converter<pixel_format::Mono12p> : packed_converter<&unpackMono12p, 0> {};
+	template<> struct native_converter<pixel_format::Mono12Packed> : packed_converter<&unpackMono12Packed, 0> {};
+	template<> struct native_converter<pixel_format::Mono10p> : packed_converter<&unpackMono10p, 0> {};
+
+	/**
+	* tH[}bgɉϊ֐̑I
+	*/
+	template<template<pixel_format> class C>
+	inline converter selectConverter(pixel_format format) {
+		switch (format) {
+		case pixel_format::BGR8: return &C<pixel_format::BGR8>::convert;
+		case pixel_format::BayerRG8: return &C<pixel_format::BayerRG8>::convert;
+		case pixel_format::BayerGB8: return &C<pixel_format::BayerGB8>::convert;
+		case pixel_format::BayerGR8: return &C<pixel_format::BayerGR8>::convert;
+		case pixel_format::BayerBG8: return &C<pixel_format::BayerBG8>::convert;
+		case pixel_format::Mono8: return &C<pixel_format::Mono8>::convert;
+		case pixel_format::Mono16: return &C<pixel_format::Mono16>::convert;
+		case pixel_format::Mono12: return &C<pixel_format::Mono12>::convert;
+		case pixel_format::BayerRG12: return &C<pixel_format::BayerRG12>::convert;
+		case pixel_format::BayerGB12: return &C<pixel_format::BayerGB12>::convert;
+		case pixel_format::BayerGR12: return &C<pixel_format::BayerGR12>::convert;
+		case pixel_format::BayerBG12: return &C<pixel_format::BayerBG12>::convert;
+		case pixel_format::Mono10: return &C<pixel_format::Mono10>::convert;
+		case pixel_format::BayerRG10: return &C<pixel_format::BayerRG10>::convert;
+		case pixel_format::BayerGB10: return &C<pixel_format::BayerGB10>::convert;
+		case pixel_format::BayerGR10: return &C<pixel_format::BayerGR10>::convert;
+		case pixel_format::BayerBG10: return &C<pixel_format::BayerBG10>::convert;
+		case pixel_format::BGR16: return &C<pixel_format::BGR16>::convert;
+		case pixel_format::BGR12: return &C<pixel_format::BGR12>::convert;
+		case pixel_format::BGR10: return &C<pixel_format::BGR10>::convert;
+		case pixel_format::Mono12p: return &C<pixel_format::Mono12p>::convert;
+		case pixel_format::Mono12Packed: return &C<pixel_format::Mono12Packed>::convert;
+		case pixel_format::Mono10p: return &C<pixel_format::Mono10p>::convert;
+		default: return &C<pixel_format::Unknown>::convert;
+		}
+	}
+
+	/**
+	* Bayer`
+	* @param[in] format sNZtH[}bg
+	* @return bool Bayer`
+	*/
+	inline bool isBayer(pixel_format format) {
+		switch (format) {
+		case pixel_format::BayerRG8:
+		case pixel_format::BayerGB8:
+		case pixel_format::BayerGR8:
+		case pixel_format::BayerBG8:
+		case pixel_format::BayerRG12:
+		case pixel_format::BayerGB12:
+		case pixel_format::BayerGR12:
+		case pixel_format::BayerBG12:
+		case pixel_format::BayerRG10:
+		case pixel_format::BayerGB10:
+		case pixel_format::BayerGR10:
+		case pixel_format::BayerBG10: return true;
+		default: return false;
+		}
+	}
+
+	/**
+	* BGR̕т̌`
+	* @param[in] format sNZtH[}bg
+	* @return bool BGR`
+	*/
+	inline bool isBGR(pixel_format format) {
+		switch (format) {
+		case pixel_format::BGR8:
+		case pixel_format::BGR16:
+		case pixel_format::BGR12:
+		case pixel_format::BGR10: return true;
+		default: return false;
+		}
+	}
+
+	/**
+	* pbNꂽ`
+	* @param[in] format sNZtH[}bg
+	* @return bool pbNꂽ`
+	*/
+	inline bool isPacked(pixel_format format) {
+		return format == pixel_format::Mono12p || format == pixel_format::Mono12Packed || format == pixel_format::Mono10p;
+	}
+
+	/**
+	* 1f1`l̗Lrbg
+	* @param[in] format sNZtH[}bg
+	* @return int rbg(8/10/12/16)
+	*/
+	inline int getSourceBits(pixel_format format) {
+		switch (format) {
+		case pixel_format::BGR8:
+		case pixel_format::Mono8:
+		case pixel_format::BayerRG8:
+		case pixel_format::BayerGB8:
+		case pixel_format::BayerGR8:
+		case pixel_format::BayerBG8: return 8;
+		case pixel_format::Mono12:
+		case pixel_format::BayerRG12:
+		case pixel_format::BayerGB12:
+		case pixel_format::BayerGR12:
+		case pixel_format::BayerBG12:
+		case pixel_format::BGR12:
+		case pixel_format::Mono12p:
+		case pixel_format::Mono12Packed: return 12;
+		case pixel_format::Mono10:
+		case pixel_format::BayerRG10:
+		case pixel_format::BayerGB10:
+		case pixel_format::BayerGR10:
+		case pixel_format::BayerBG10:
+		case pixel_format::BGR10:
+		case pixel_format::Mono10p: return 10;
+		default: return 16;
+		}
+	}
+
+	/**
+	* o͂̎w肪ꍇ̌^
+	* @param[in] format sNZtH[}bg
+	* @param[in] opt ϊ̐ݒ
+	* @return int cv::Mať^(ΉȂ-1)
+	*/
+	inline int getNaturalType(pixel_format format, const convert_options& opt) {
+		if (format == pixel_format::Unknown)return -1;
+		int depth = getSourceBits(format) == 8 ? CV_8U : CV_16U;
+		bool color = isBGR(format) || (isBayer(format) && opt.demosaic != demosaic_method::none);
+		return CV_MAKETYPE(depth, color ? 3 : 1);
+	}
+
+	/**
+	* o͂̌^
+	* @param[in] format sNZtH[}bg
+	* @param[in] opt ϊ̐ݒ
+	* @return int cv::Mať^(ΉȂ-1)
+	*/
+	inline int getOutputType(pixel_format format, const convert_options& opt) {
+		if (format == pixel_format::Unknown)return -1;
+		return opt.output.type >= 0 ? opt.output.type : getNaturalType(format, opt);
+	}
+
+	/**
+	* o͂̎wɍ킹ϊKv
+	* @param[in] format sNZtH[}bg
+	* @param[in] opt ϊ̐ݒ
+	* @return bool Kv
+	*/
+	inline bool needsOutputConversion(pixel_format format, const convert_options& opt) {
+		if (format == pixel_format::Unknown || !opt.output.active())return false;
+		return opt.output.scale != 1.0 || opt.output.type != getNaturalType(format, opt);
+	}
+
+	/**
+	* obt@̂܂cv::MatƂĕԂꍇ̌^([Rs[p)
+	* @param[in] format sNZtH[}bg
+	* @param[in] opt ϊ̐ݒ
+	* @return int cv::Mať^(ϊKvȂ-1)
+	*/
+	inline int getDirectType(pixel_format format, const convert_options& opt) {
+		if (isBayer(format) && opt.demosaic != demosaic_method::none)return -1;
+		if (needsOutputConversion(format, opt))return -1;
+		switch (format) {
+		case pixel_format::BGR8: return CV_8UC3;
+		case pixel_format::Mono8:
+		case pixel_format::BayerRG8:
+		case pixel_format::BayerGB8:
+		case pixel_format::BayerGR8:
+		case pixel_format::BayerBG8: return CV_8UC1;
+		case pixel_format::Mono16:
+		case pixel_format::Mono12:
+		case pixel_format::BayerRG12:
+		case pixel_format::BayerGB12:
+		case pixel_format::BayerGR12:
+		case pixel_format::BayerBG12:
+		case pixel_format::Mono10:
+		case pixel_format::BayerRG10:
+		case pixel_format::BayerGB10:
+		case pixel_format::BayerGR10:
+		case pixel_format::BayerBG10: return CV_16UC1;
+		default: return -1;
+		}
+	}
+
+	/**
+	* 16bitɑ邽߂̃Vtg
+	* @param[in] format sNZtH[}bg
+	* @return int Vtg[bit]
+	*/
+	inline int getBitShift(pixel_format format) {
+		switch (format) {
+		case pixel_format::Mono12:
+		case pixel_format::BayerRG12:
+		case pixel_format::BayerGB12:
+		case pixel_format::BayerGR12:
+		case pixel_format::BayerBG12:
+		case pixel_format::BGR12:
+		case pixel_format::Mono12p:
+		case pixel_format::Mono12Packed: return 4;
+		case pixel_format::Mono10:
+		case pixel_format::BayerRG10:
+		case pixel_format::BayerGB10:
+		case pixel_format::BayerGR10:
+		case pixel_format::BayerBG10:
+		case pixel_format::BGR10:
+		case pixel_format::Mono10p: return 6;
+		default: return 0;
+		}
+	}
+	/**
+	* o͂̑傫
+	* @param[in] width 
+	* @param[in] height 
+	* @param[in] scale k
+	* @return cv::Size o͂̑傫
+	*/
+	inline cv::Size getOutputSize(int width, int height, double scale) {
+		if (scale >= 1.0)return cv::Size(width, height);
+		return cv::Size(std::max(1, (int)(width * scale)), std::max(1, (int)(height * scale)));
+	}
+
+	/**
+	* Bayer̃O[XP[ϊR[h̎擾
+	* @param[in] pattern Bayer̕
+	* @return int ϊR[h
+	*/
+	inline int getBayerGrayCode(bayer_pattern pattern) {
+		static const int codes[4] = { cv::COLOR_BayerBG2GRAY, cv::COLOR_BayerGR2GRAY, cv::COLOR_BayerGB2GRAY, cv::COLOR_BayerRG2GRAY };
+		return codes[(int)pattern];
+	}
+
+	/**
+	* sNZtH[}bgBayer̕
+	* @param[in] format sNZtH[}bg(Bayer`)
+	* @return bayer_pattern Bayer̕
+	*/
+	inline bayer_pattern getBayerPattern(pixel_format format) {
+		switch (format) {
+		case pixel_format::BayerGB8:
+		case pixel_format::BayerGB10:
+		case pixel_format::BayerGB12: return bayer_pattern::GB;
+		case pixel_format::BayerGR8:
+		case pixel_format::BayerGR10:
+		case pixel_format::BayerGR12: return bayer_pattern::GR;
+		case pixel_format::BayerBG8:
+		case pixel_format::BayerBG10:
+		case pixel_format::BayerBG12: return bayer_pattern::BG;
+		default: return bayer_pattern::RG;
+		}
+	}
+
+	/**
+	* rbg킹Vtg(Ȃ獶,ȂE)
+	* @param[in] v l
+	* @param[in] shift Vtg[bit]
+	* @return int Vtg̒l
+	*/
+	inline int shiftBits(int v, int shift) {
+		return shift >= 0 ? (v << shift) : (v >> -shift);
+	}
+
+	/**
+	* o͂̃rbgɍ킹Vtg
+	* @param[in] format sNZtH[}bg
+	* @param[in] depth o͂̐[x(CV_8U/CV_16U)
+	* @param[in] nativeBitDepth 16bito͂Ō̃rbg[x̂܂ܕԂ
+	* @return int Vtg[bit](Ȃ獶,ȂE)
+	*/
+	inline int getOutputShift(pixel_format format, int depth, bool nativeBitDepth) {
+		int bits = getSourceBits(format);
+		return (depth == CV_8U ? 8 : (nativeBitDepth ? bits : 16)) - bits;
+	}
+
+	/**
+	* 2x2Ƃɂ܂Ƃ߂̑傫ւ̏k
+	* Bayer1ubN1fBGR(܂͋Px)邽,fUCNƏkƃrbg̕ϊ1̑ōς
+	* @param[in] src 1`l̉摜(Mono/Bayer)
+	* @param[out] dst o(src.cols / 2 x src.rows / 2, mۍς)
+	* @param[in] bayer BayerƂĈ(falseȂ4f̕)
+	* @param[in] pattern Bayer̕
+	* @param[in] shift o͂̃rbgɍ킹Vtg(Ȃ獶,ȂE)
+	*/
+	template<typename S, typename D, int Channels>
+	inline void reduceBlocks(const cv::Mat& src, cv::Mat& dst, bool bayer, bayer_pattern pattern, int shift) {
+		const int rx = (pattern == bayer_pattern::RG || pattern == bayer_pattern::GB) ? 0 : 1;
+		const int ry = (pattern == bayer_pattern::RG || pattern == bayer_pattern::GR) ? 0 : 1;
+
+		cv::parallel_for_(cv::Range(0, dst.rows), [&](const cv::Range& range) {
+			for (int y = range.start; y < range.end; y++) {
+				const S* s0 = src.ptr<S>(y * 2);
+				const S* s1 = src.ptr<S>(y * 2 + 1);
+				const S* sr = ry == 0 ? s0 : s1;
+				const S* sb = ry == 0 ? s1 : s0;
+				D* d = dst.ptr<D>(y);
+
+				for (int x = 0; x < dst.cols; x++, d += Channels) {
+					int sx = x * 2;
+					if (!bayer) {
+						int v = shiftBits((s0[sx] + s0[sx + 1] + s1[sx] + s1[sx + 1] + 2) >> 2, shift);
+						for (int c = 0; c < Channels; c++)d[c] = (D)v;
+						continue;
+					}
+					int r = sr[sx + rx];
+					int g2 = sr[sx + (rx ^ 1)] + sb[sx + rx];
+					int b = sb[sx + (rx ^ 1)];
+					if (Channels == 1) {
+						//BT.601̏d(R:G:B = 77:150:29)
+						d[0] = (D)shiftBits((r * 77 + g2 * 75 + b * 29 + 128) >> 8, shift);
+					} else {
+						d[0] = (D)shiftBits(b, shift);
+						d[1] = (D)shiftBits((g2 + 1) >> 1, shift);
+						d[2] = (D)shiftBits(r, shift);
+					}
+				}
+			}
+		});
+	}
+
+	/**
+	* ^ɉ2x2Ƃ̏ǩĂяo
+	* @param[in] src 1`l̉摜(CV_8UC1/CV_16UC1)
+	* @param[out] dst o(mۍς)
+	* @param[in] bayer BayerƂĈ
+	* @param[in] pattern Bayer̕
+	* @param[in] shift o͂̃rbgɍ킹Vtg
+	*/
+	inline void reduceBlocks(const cv::Mat& src, cv::Mat& dst, bool bayer, bayer_pattern pattern, int shift) {
+		bool src8 = src.depth() == CV_8U;
+		bool dst8 = dst.depth() == CV_8U;
+		bool gray = dst.channels() == 1;
+		if (src8 && dst8) {
+			gray ? reduceBlocks<uchar, uchar, 1>(src, dst, bayer, pattern, shift) : reduceBlocks<uchar, uchar, 3>(src, dst, bayer, pattern, shift);
+		} else if (src8) {
+			gray ? reduceBlocks<uchar, ushort, 1>(src, dst, bayer, pattern, shift) : reduceBlocks<uchar, ushort, 3>(src, dst, bayer, pattern, shift);
+		} else if (dst8) {
+			gray ? reduceBlocks<ushort, uchar, 1>(src, dst, bayer, pattern, shift) : reduceBlocks<ushort, uchar, 3>(src, dst, bayer, pattern, shift);
+		} else {
+			gray ? reduceBlocks<ushort, ushort, 1>(src, dst, bayer, pattern, shift) : reduceBlocks<ushort, ushort, 3>(src, dst, bayer, pattern, shift);
+		}
+	}
+
+	/**
+	* o͂̌^Ƒ傫ւ̎dグ
+	* `l炷ϊ,k,rbg̕ϊ,`l𑝂₷ϊ̏,f[^ʂȂȂ鏇ōs,
+	* Ō̏͏o͐֒ڏ
+	* @param[in] src ϊr̉摜
+	* @param[out] dst 摜o
+	* @param[in] type o͂̌^
+	* @param[in] shift o͂̃rbgɍ킹Vtg(Ȃ獶,ȂE)
+	* @param[in] size o͂̑傫
+	*/
+	inline void finishOutput(const cv::Mat& src, cv::Mat& dst, int type, int shift, cv::Size size) {
+		thread_local cv::Mat gray, resized, scaled;
+		const int channels = CV_MAT_CN(type);
+		const int depth = CV_MAT_DEPTH(type);
+		bool toGray = src.channels() == 3 && channels == 1;
+		bool toColor = src.channels() == 1 && channels == 3;
+		bool toSize = src.cols != size.width || src.rows != size.height;
+		bool toDepth = src.depth() != depth || shift != 0;
+
+		cv::Mat im = src;
+		if (toGray) {
+			cv::Mat& out = (toSize || toDepth) ? gray : dst;
+			createOutput(out, im.rows, im.cols, CV_MAKETYPE(im.depth(), 1));
+			cv::cvtColor(im, out, cv::COLOR_BGR2GRAY);
+			im = out;
+		}
+		if (toSize) {
+			cv::Mat& out = (toDepth || toColor) ? resized : dst;
+			createOutput(out, size.height, size.width, im.type());
+			cv::resize(im, out, size, 0, 0, cv::INTER_AREA);
+			im = out;
+		}
+		if (toDepth) {
+			cv::Mat& out = toColor ? scaled : dst;
+			createOutput(out, im.rows, im.cols, CV_MAKETYPE(depth, im.channels()));
+			if (im.depth() == depth) {
+				shiftLeft16(im.ptr<ushort>(), out.ptr<ushort>(), im.total() * im.channels(), shift);
+			} else {
+				im.convertTo(out, depth, shift >= 0 ? (double)(1 << shift) : 1.0 / (1 << -shift));
+			}
+			im = out;
+		}
+		if (toColor) {
+			createOutput(dst, im.rows, im.cols, CV_MAKETYPE(depth, 3));
+			cv::cvtColor(im, dst, cv::COLOR_GRAY2BGR);
+			im = dst;
+		}
+		if (!toGray && !toSize && !toDepth && !toColor) {
+			createOutput(dst, im.rows, im.cols, im.type());
+			im.copyTo(dst);
+		}
+	}
+
+	/**
+	* o͂̌^Ƒ傫̎wɍ킹ϊ
+	* rőSf̉摜蒼Ȃ悤,krbg̕ϊfUCNȂǂƍ킹čs
+	* Ek0.5ȉ: 2x2ƂɃfUCN(܂̓O[XP[)ƃrbg̕ϊ1ōs,c̏k͏摜ōs
+	* EBayer8bit: fUCN̑OBayer̂܂8bitɂ(fUCN̓o͂ɂȂ)
+	* EBayer1`l: BGRoRɋPxɂ
+	* @param[in] src ϊỎ摜
+	* @param[out] dst 摜o
+	* @param[in] opt ϊ̐ݒ
+	* @param[in] nativeBitDepth 16bito͂Ō̃rbg[x̂܂ܕԂ
+	*/
+	inline void convertToOutput(const raw_frame& src, cv::Mat& dst, const convert_options& opt, bool nativeBitDepth) {
+		thread_local cv::Mat unpacked, narrowed, full;
+		const int type = getOutputType(src.format, opt);
+		if (type < 0) {
+			dst.release();
+			return;
+		}
+		const int channels = CV_MAT_CN(type);
+		const int depth = CV_MAT_DEPTH(type);
+		const int bits = getSourceBits(src.format);
+		int shift = getOutputShift(src.format, depth, nativeBitDepth);
+		const cv::Size size = getOutputSize(src.width, src.height, opt.output.scale);
+		const int srcDepth = bits == 8 ? CV_8U : CV_16U;
+
+		if (isBGR(src.format)) {
+			cv::Mat im(src.height, src.width, CV_MAKETYPE(srcDepth, 3), src.data);
+			finishOutput(im, dst, type, shift, size);
+			return;
+		}
+
+		//1`l̉摜(Mono/Bayer)
+		cv::Mat plane;
+		if (isPacked(src.format)) {
+			createOutput(unpacked, src.height, src.width, CV_16UC1);
+			if (src.format == pixel_format::Mono12p) {
+				unpackMono12p((const uchar*)src.data, unpacked.ptr<ushort>(), unpacked.total(), 0);
+			} else if (src.format == pixel_format::Mono12Packed) {
+				unpackMono12Packed((const uchar*)src.data, unpacked.ptr<ushort>(), unpacked.total(), 0);
+			} else {
+				unpackMono10p((const uchar*)src.data, unpacked.ptr<ushort>(), unpacked.total(), 0);
+			}
+			plane = unpacked;
+		} else {
+			plane = cv::Mat(src.height, src.width, CV_MAKETYPE(srcDepth, 1), src.data);
+		}
+		const bool bayer = isBayer(src.format) && (channels == 3 || opt.demosaic != demosaic_method::none);
+		const bayer_pattern pattern = getBayerPattern(src.format);
+
+		//k0.5ȉ2x2Ƃɂ܂Ƃ߂
+		if (opt.output.scale <= 0.5 && plane.cols >= 2 && plane.rows >= 2) {
+			bool last = size.width == plane.cols / 2 && size.height == plane.rows / 2;
+			cv::Mat& out = last ? dst : full;
+			createOutput(out, plane.rows / 2, plane.cols / 2, type);
+			reduceBlocks(plane, out, bayer, pattern, shift);
+			if (!last)finishOutput(full, dst, type, 0, size);
+			return;
+		}
+
+		if (!bayer) {
+			finishOutput(plane, dst, type, shift, size);
+			return;
+		}
+
+		//8bitւ̓fUCN̑OɗƂ
+		if (shift < 0) {
+			createOutput(narrowed, plane.rows, plane.cols, CV_8UC1);
+			plane.convertTo(narrowed, CV_8U, 1.0 / (1 << -shift));
+			plane = narrowed;
+			shift = 0;
+		}
+		bool direct = size.width == plane.cols && size.height == plane.rows && plane.depth() == depth;
+		cv::Mat& out = direct ? dst : full;
+		if (channels == 1) {
+			createOutput(out, plane.rows, plane.cols, plane.type());
+			cv::cvtColor(plane, out, getBayerGrayCode(pattern));
+		} else {
+			demosaic(plane, out, pattern, opt.demosaic == demosaic_method::none ? demosaic_method::bilinear : opt.demosaic);
+		}
+		if (!direct) {
+			finishOutput(full, dst, type, shift, size);
+		} else if (shift > 0) {
+			shiftLeft16(dst.ptr<ushort>(), dst.ptr<ushort>(), dst.total() * dst.channels(), shift);
+		}
+	}
+
+	/**
+	* ϊƍ킹s~bh̐
+	* 1iڂ̓ZT̉摜(Mono/Bayer)2x2Ƃɒڍ邽,ϊ̑Sf̉摜ǂݒȂ
+	* (Bayeȓ͔傫ł̃fUCNɂȂ.2iڈȍ~͑O̒i2x2̕ςŏk)
+	* o͓͐傫,^łΑÖ̗ėp
+	* @param[in] src ϊỎ摜
+	* @param[in] base ϊ̉摜
+	* @param[out] levels s~bh(levels[0]baseƓ摜,levels[i]1/2^ȋ傫.Ȃ肷i͍Ȃ)
+	* @param[in] count ki
+	* @param[in] opt ϊ̐ݒ
+	* @param[in] nativeBitDepth 16bito͂Ō̃rbg[x̂܂ܕԂ
+	*/
+	inline void buildPyramid(const raw_frame& src, const cv::Mat& base, std::vector<cv::Mat>& levels, int count, const convert_options& opt, bool nativeBitDepth) {
+		levels.resize(count + 1);
+		levels[0] = base;
+		if (base.empty()) {
+			levels.resize(1);
+			return;
+		}
+
+		//[Rs[ł͕ϊ̉摜ZT̉摜̂(Vtgς)Ȃ̂,炩k
+		bool fromRaw = src.format != pixel_format::Unknown && !isBGR(src.format) && !isPacked(src.format) &&
+			base.cols == src.width && base.rows == src.height && base.data != (const uchar*)src.data;
+		for (int i = 1; i <= count; i++) {
+			const cv::Mat& prev = levels[i - 1];
+			if (prev.cols < 2 || prev.rows < 2) {
+				levels.resize(i);
+				return;
+			}
+			createOutput(levels[i], prev.rows / 2, prev.cols / 2, base.type());
+			if (i == 1 && fromRaw) {
+				cv::Mat plane(src.height, src.width, getSourceBits(src.format) == 8 ? CV_8UC1 : CV_16UC1, src.data);
+				bool bayer = isBayer(src.format) && (base.channels() == 3 || opt.demosaic != demosaic_method::none);
+				reduceBlocks(plane, levels[i], bayer, getBayerPattern(src.format), getOutputShift(src.format, base.depth(), nativeBitDepth));
+			} else {
+				cv::resize(prev, levels[i], cv::Size(prev.cols / 2, prev.rows / 2), 0, 0, cv::INTER_AREA);
+			}
+		}
+	}
+
+	/**
+	* o͂̎wɍ킹ϊ
+	*/
+	template<bool NativeBitDepth>
+	struct output_converter {
+		static void convert(const raw_frame& src, cv::Mat& dst, const convert_options& opt) {
+			convertToOutput(src, dst, opt, NativeBitDepth);
+		}
+	};
+
+	/**
+	* o͂̎w邽߂̕ϊ̏d̖ڈ(sNZtH[}bg̑Ip)
+	* ](4bitP)ƕϊ̎Ԃ̘a,FrbgȂ`͑傫
+	* @param[in] format sNZtH[}bg
+	* @param[in] spec o͂̎w
+	* @param[in] method fUCN@
+	* @return int d(قǌy. ΉȂ-1)
+	*/
+	inline int getOutputCost(pixel_format format, const output_spec& spec, demosaic_method method = demosaic_method::bilinear) {
+		if (format == pixel_format::Unknown)return -1;
+		convert_options opt;
+		opt.demosaic = method;
+		opt.output = spec;
+		const int type = getOutputType(format, opt);
+		const int channels = CV_MAT_CN(type);
+		const int bits = getSourceBits(format);
+		const bool color = isBGR(format) || isBayer(format);
+		const bool reduce = spec.scale <= 0.5;
+
+		int cost = (isPacked(format) ? bits : (bits == 8 ? 8 : 16)) * (isBGR(format) ? 3 : 1) / 4;
+		if (channels == 3 && !color)cost += 100;	//F
+		if (CV_MAT_DEPTH(type) == CV_16U)cost += (16 - bits) / 2 + (bits == 8 ? 100 : 0);	//rbgȂ
+		if (isPacked(format))cost += 2;
+		if (isBayer(format))cost += channels == 3 ? (reduce ? 1 : 5) : 2;
+		if (isBGR(format) && channels == 1)cost += 3;
+		if (spec.scale != 1.0)cost += reduce && !isBGR(format) ? 0 : 2;
+		if (type != getNaturalType(format, opt))cost += 1;
+		return cost;
+	}
+
+	/**
+	* ϊ֐̎擾(Xg[JnɈxĂ)
+	* @param[in] format sNZtH[}bg
+	* @param[in] nativeBitDepth 10/12bit16bitɑ̂܂ܕԂ
+	* @param[in] opt ϊ̐ݒ(o͂̎w肪΂ɍ킹ϊI)
+	* @return converter ϊ֐
+	*/
+	inline converter getConverter(pixel_format format, bool nativeBitDepth = false, const convert_options& opt = convert_options()) {
+		if (needsOutputConversion(format, opt)) {
+			return nativeBitDepth ? &output_converter<true>::convert : &output_converter<false>::convert;
+		}
+		if (nativeBitDepth)return selectConverter<native_converter>(format);
+		return selectConverter<format_converter>(format);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,324 @@
+#ifndef RSDLAB_BAUMER_EXPOSURE
+#define RSDLAB_BAUMER_EXPOSURE
+
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include "BaumerConvert.h"
+
+namespace baumer {
+	/**
+	* Io(IԂƃQC̎)̐ݒ
+	*/
+	struct exposure_config {
+		double target = 0.45;			//ڕW̕ϋPx(0-1)
+		double tolerance = 0.05;		//ڕWƂ̍ȓȂύXȂ(qXeVX)
+		double maxSaturated = 0.02;		//Oaf̊̏(Â)
+		double damping = 0.6;			//1̍XVŕ␳銄(0-1, قǊɂ₩)
+		double maxRate = 10.0;			//1b̍őXV
+		int settleFrames = 2;			//ύXɓv炸ɑ҂摜(ݒ肪摜ɔf܂)
+		int subsample = 7;				//vs̊Ԋu(Ȃ1𑫂. Bayer͊ԊuŐF̈Ⴄs݂Ɍ)
+		double maxExposure = 0;			//QCグn߂I(0ȂJ̍ő)
+		bool useGain = true;			//IԂɒBQCグ邩
+	};
+
+	/**
+	* Iȍ
+	*/
+	struct exposure_stats {
+		uint64_t samples = 0;		//v
+		uint64_t updates = 0;		//I,QCύX
+		double mean = 0;			//߂̕ϋPx(0-1)
+		double saturated = 0;		//߂̖Oaf̊
+		double exposure = 0;		//݂̘I
+		double gain = 0;			//݂̃QC[dB]
+		bool converged = false;		//ڕW͈͓̔
+	};
+
+	/**
+	* 8bit̒l̃qXgOւ̉Z
+	* 4̕\ɐU蕪,KƂɏ݂҂Ȃ悤ɂ
+	* @param[in] p l
+	* @param[in] n 
+	* @param[in,out] h qXgO(4)
+	*/
+	inline void countBytes(const uchar* p, size_t n, uint32_t(*h)[256]) {
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4) {
+			h[0][p[i]]++;
+			h[1][p[i + 1]]++;
+			h[2][p[i + 2]]++;
+			h[3][p[i + 3]]++;
+		}
+		for (; i < n; i++) {
+			h[0][p[i]]++;
+		}
+	}
+
+	/**
+	* 16bit̒l̏8bit̃qXgOւ̉Z
+	* Vtg8bitւ̋lߒSSE2/NEONł܂Ƃ߂čs
+	* @param[in] p l
+	* @param[in] n 
+	* @param[in] shift 8bitɂ邽߂̉EVtg
+	* @param[in,out] h qXgO(4)
+	*/
+	inline void countWords(const ushort* p, size_t n, int shift, uint32_t(*h)[256]) {
+		uchar narrow[256];
+		while (n > 0) {
+			size_t m = std::min(n, sizeof(narrow));
+			size_t i = 0;
+#if defined(RSDLAB_BAUMER_SSE2)
+			__m128i count = _mm_cvtsi32_si128(shift);
+			for (; i + 16 <= m; i += 16) {
+				__m128i a = _mm_srl_epi16(_mm_loadu_si128((const __m128i*)(p + i)), count);
+				__m128i b = _mm_srl_epi16(_mm_loadu_si128((const __m128i*)(p + i + 8)), count);
+				_mm_storeu_si128((__m128i*)(narrow + i), _mm_packus_epi16(a, b));
+			}
+#elif defined(RSDLAB_BAUMER_NEON)
+			int16x8_t count = vdupq_n_s16((short)-shift);
+			for (; i + 16 <= m; i += 16) {
+				uint16x8_t a = vshlq_u16(vld1q_u16(p + i), count);
+				uint16x8_t b = vshlq_u16(vld1q_u16(p + i + 8), count);
+				vst1q_u8(narrow + i, vcombine_u8(vqmovn_u16(a), vqmovn_u16(b)));
+			}
+#endif
+			for (; i < m; i++) {
+				narrow[i] = (uchar)std::min(255, p[i] >> shift);
+			}
+			countBytes(narrow, m, h);
+			p += m;
+			n -= m;
+		}
+	}
+
+	/**
+	* ϊỎ摜ԈPx̃qXgO
+	* stepƂ̍sǂ,l͏8bitŐ(BGRBayer͐FʂȂ)
+	* pbNꂽ`͏8bit̂܂ܓĂbyteǂ
+	* @param[in] src ϊỎ摜
+	* @param[in] step s̊Ԋu
+	* @param[out] hist qXgO(256K)
+	* @return uint64_t f
+	*/
+	inline uint64_t computeHistogram(const raw_frame& src, int step, uint32_t* hist) {
+		uint32_t h[4][256] = {};
+		memset(hist, 0, sizeof(uint32_t) * 256);
+		if (src.data == NULL || src.width <= 0 || src.height <= 0 || src.format == pixel_format::Unknown)return 0;
+		step = std::max(1, step | 1);
+
+		const int bits = getSourceBits(src.format);
+		const uchar* data = (const uchar*)src.data;
+		uint64_t n = 0;
+		if (isPacked(src.format)) {
+			//Mono12p: 3byte, Mono12Packed: 1byte, Mono10p: 5byteڂ8bit
+			size_t period = src.format == pixel_format::Mono10p ? 5 : 3;
+			size_t offset = src.format == pixel_format::Mono12p ? 2 : (src.format == pixel_format::Mono10p ? 4 : 0);
+			size_t bytes = ((size_t)src.width * src.height * bits + 7) / 8;
+			for (size_t i = offset; i < bytes; i += period * step) {
+				h[0][data[i]]++;
+				n++;
+			}
+		} else {
+			size_t values = (size_t)src.width * (isBGR(src.format) ? 3 : 1);
+			size_t stride = values * (bits == 8 ? 1 : 2);
+			for (int y = 0; y < src.height; y += step) {
+				const uchar* row = data + stride * y;
+				if (bits == 8) {
+					countBytes(row, values, h);
+				} else {
+					countWords((const ushort*)row, values, bits - 8, h);
+				}
+				n += values;
+			}
+		}
+
+		for (int i = 0; i < 256; i++) {
+			hist[i] = h[0][i] + h[1][i] + h[2][i] + h[3][i];
+		}
+		return n;
+	}
+
+	/**
+	* \tgEFA̎Io
+	* ϊ̓rŌĂ΂,߂ꂽpxƂɊԈqXgO畽ϋPx߂ĘIԂƃQCXV
+	* ڕWƂ̍e͈͓ȂύXȂ. ύX͉摜ɔf܂Ő҂
+	* (̃XbhĂ΂Ă,v͓̂1Xbh)
+	*/
+	class auto_exposure {
+	private:
+		std::mutex mutex;
+		std::atomic<bool> enabled{ false };
+		exposure_config config;
+		std::function<bool(double, double)> apply;
+		double exposureMin = 0;
+		double exposureMax = 0;
+		double gainMin = 0;
+		double gainMax = 0;
+		uint64_t lastSample = 0;
+		int settle = 0;
+		exposure_stats stats;
+
+		/**
+		* dB{ւ̕ϊ
+		* @param[in] db QC[dB]
+		* @return double {
+		*/
+		static inline double toLinear(double db) {
+			return std::pow(10.0, db / 20.0);
+		}
+
+		/**
+		* {dBւ̕ϊ
+		* @param[in] linear {
+		* @return double QC[dB]
+		*/
+		static inline double toDecibel(double linear) {
+			return 20.0 * std::log10(linear);
+		}
+
+	public:
+		/**
+		* Io̊Jn
+		* @param[in] c ݒ
+		* @param[in] exposure ݂̘I
+		* @param[in] eMin IԂ̍ŏl
+		* @param[in] eMax IԂ̍ől
+		* @param[in] gain ݂̃QC[dB]
+		* @param[in] gMin QC̍ŏl(őlƓȂQC͕ςȂ)
+		* @param[in] gMax QC̍ől
+		* @param[in] writer IԂƃQCފ֐(߂true)
+		*/
+		void configure(const exposure_config& c, double exposure, double eMin, double eMax, double gain, double gMin, double gMax, std::function<bool(double, double)> writer) {
+			std::lock_guard<std::mutex> lock(mutex);
+			config = c;
+			apply = writer;
+			exposureMin = eMin;
+			exposureMax = eMax;
+			gainMin = gMin;
+			gainMax = gMax;
+			stats = exposure_stats();
+			stats.exposure = exposure;
+			stats.gain = gain;
+			lastSample = 0;
+			settle = 0;
+			enabled = true;
+		}
+
+		/**
+		* Io̒~
+		*/
+		void disable() {
+			std::lock_guard<std::mutex> lock(mutex);
+			enabled = false;
+		}
+
+		/**
+		* L
+		* @return bool L
+		*/
+		inline bool isEnabled() const {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		/**
+		* ݒ̎擾
+		* @return exposure_config ݒ
+		*/
+		exposure_config getConfig() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return config;
+		}
+
+		/**
+		* Ԃ̎擾
+		* @return exposure_stats 
+		*/
+		exposure_stats getStats() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return stats;
+		}
+
+		/**
+		* OύXꂽI,QC𔽉f
+		* @param[in] exposure I
+		* @param[in] gain QC[dB]
+		*/
+		void sync(double exposure, double gain) {
+			std::lock_guard<std::mutex> lock(mutex);
+			stats.exposure = exposure;
+			stats.gain = gain;
+			settle = config.settleFrames;
+		}
+
+		/**
+		* 摜Ƃ̍XV
+		* @param[in] src ϊỎ摜
+		* @param[in] now 󂯎[nsec]
+		*/
+		void update(const raw_frame& src, uint64_t now) {
+			if (!isEnabled())return;
+			std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+			if (!lock.owns_lock() || !enabled)return;
+			if (settle > 0) {
+				settle--;
+				return;
+			}
+			if (lastSample != 0 && now - lastSample < (uint64_t)(1e9 / config.maxRate))return;
+
+			uint32_t hist[256];
+			uint64_t n = computeHistogram(src, config.subsample, hist);
+			if (n == 0)return;
+			lastSample = now;
+
+			double sum = 0;
+			for (int i = 0; i < 256; i++) {
+				sum += (double)i * hist[i];
+			}
+			stats.samples++;
+			stats.mean = sum / n / 255.0;
+			stats.saturated = (double)(hist[254] + hist[255]) / n;
+
+			bool over = stats.saturated > config.maxSaturated;
+			stats.converged = !over && std::fabs(stats.mean - config.target) <= config.tolerance;
+			if (stats.converged)return;
+
+			double ratio = config.target / std::max(stats.mean, 1.0 / 255.0);
+			if (over)ratio = std::min(ratio, 0.8);
+			ratio = std::max(0.25, std::min(4.0, std::pow(ratio, config.damping)));
+
+			//IԂɎg,ɒBQCグ(ÂƂ̓QC牺)
+			double total = stats.exposure * toLinear(stats.gain) * ratio;
+			double limit = config.maxExposure > 0 ? std::min(config.maxExposure, exposureMax) : exposureMax;
+			double exposure, gain;
+			if (!config.useGain || gainMax <= gainMin) {
+				gain = stats.gain;
+				exposure = std::max(exposureMin, std::min(exposureMax, total / toLinear(gain)));
+			} else if (total / toLinear(gainMin) <= limit) {
+				gain = gainMin;
+				exposure = std::max(exposureMin, total / toLinear(gainMin));
+			} else {
+				exposure = limit;
+				gain = std::max(gainMin, std::min(gainMax, toDecibel(total / limit)));
+			}
+
+			//,ɒtĂꍇ͏܂Ȃ
+			if (std::fabs(exposure - stats.exposure) <= stats.exposure * 0.005 && std::fabs(gain - stats.gain) < 0.01)return;
+			if (!apply(exposure, gain))return;
+			stats.exposure = exposure;
+			stats.gain = gain;
+			stats.updates++;
+			settle = config.settleFrames;
+		}
+	};
+}
+
+#endif
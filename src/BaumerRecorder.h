@@ -0,0 +1,511 @@
+#ifndef RSDLAB_BAUMER_RECORDER
+#define RSDLAB_BAUMER_RECORDER
+
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#define RSDLAB_BAUMER_UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef RSDLAB_BAUMER_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef RSDLAB_BAUMER_UNDEF_NOMINMAX
+#endif
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+* ϊ̉摜L^Reit@C
+* [raw_file_header (RAW_FILE_ALIGNMENT)] [raw_record_header + 摜 + lߕ] [raw_record_header + 摜 + lߕ] ...
+* R[h̓y[WEɑ,wb_̖͏݂̂тɍXV邽,rŎ~܂Ă܂ł͓ǂ߂
+*/
+
+namespace baumer {
+	static const uint64_t RAW_FILE_ALIGNMENT = 4096;			//R[h̋E
+	static const uint64_t RAW_RECORD_PAYLOAD_OFFSET = 128;		//R[h擪摜܂ł̃ItZbg
+	static const char RAW_FILE_MAGIC[8] = { 'B', 'M', 'R', 'A', 'W', '0', '0', '1' };
+
+	/**
+	* Reit@C̃wb_
+	*/
+	struct raw_file_header {
+		char magic[8];				//RAW_FILE_MAGIC
+		uint32_t version;			//`̔(1)
+		uint32_t headerSize;		//wb_̈̑傫(ŏ̃R[ḧʒu)
+		uint64_t frameCount;		//ݍς݂̃R[h
+		uint64_t dataEnd;			//ݍς݂̖̈ʒu
+		char serialNumber[32];		//L^J̃VAio[
+		char model[32];				//L^J̃f
+	};
+
+	/**
+	* R[h̃wb_(Œ蒷,zXg̃oCg)
+	*/
+	struct raw_record_header {
+		uint64_t recordSize;		//̃R[h܂ł̑傫
+		uint64_t payloadSize;		//摜̑傫
+		uint64_t timestamp;			//J̃^CX^v
+		uint64_t frameID;			//t[ԍ
+		uint64_t hostTimestamp;		//zXgobt@󂯎[nsec]
+		int32_t width;				//
+		int32_t height;				//
+		int32_t offsetX;			//ROI̍X
+		int32_t offsetY;			//ROI̍Y
+		uint32_t flags;				//RAW_RECORD_INCOMPLETEȂ
+		uint32_t reserved;
+		char pixelFormat[32];		//J̃sNZtH[}bg
+	};
+	static const uint32_t RAW_RECORD_INCOMPLETE = 1;
+	static_assert(sizeof(raw_record_header) <= RAW_RECORD_PAYLOAD_OFFSET, "raw_record_header is too large");
+
+	/**
+	* }bvt@C
+	*/
+	class mapped_file {
+	private:
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = NULL;
+#else
+		int fd = -1;
+#endif
+		char* ptr = NULL;
+		uint64_t length = 0;
+		bool writable = false;
+
+	public:
+		mapped_file() {}
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		~mapped_file() {
+			close();
+		}
+
+		/**
+		* ݗpɍ쐬Ċmۂ
+		* ݒɃfBXNȂȂȂ悤,ɑŜmۂ
+		* @param[in] path pX
+		* @param[in] size 傫
+		* @return bool 쐬ł
+		*/
+		bool create(const std::string& path, uint64_t size) {
+			close();
+#ifdef _WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (file == INVALID_HANDLE_VALUE)return false;
+			mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+			if (mapping != NULL)ptr = (char*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+#else
+			fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (fd < 0)return false;
+#ifdef __linux__
+			if (posix_fallocate(fd, 0, (off_t)size) != 0) {
+#else
+			if (ftruncate(fd, (off_t)size) != 0) {
+#endif
+				close();
+				return false;
+			}
+			void* p = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				ptr = (char*)p;
+				madvise(p, (size_t)size, MADV_SEQUENTIAL);
+			}
+#endif
+			length = size;
+			writable = true;
+			if (ptr == NULL) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		* ǂݍݗpɊJ
+		* @param[in] path pX
+		* @return bool J
+		*/
+		bool open(const std::string& path) {
+			close();
+#ifdef _WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (file == INVALID_HANDLE_VALUE)return false;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+				close();
+				return false;
+			}
+			length = (uint64_t)size.QuadPart;
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping != NULL)ptr = (char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+			fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)return false;
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				close();
+				return false;
+			}
+			length = (uint64_t)st.st_size;
+			void* p = mmap(NULL, (size_t)length, PROT_READ, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				ptr = (char*)p;
+				madvise(p, (size_t)length, MADV_SEQUENTIAL);
+			}
+#endif
+			writable = false;
+			if (ptr == NULL) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		* 
+		* @param[in] truncate ݗp̂Ƃ,̑傫ɐ؂l߂(0Ȃ؂l߂Ȃ)
+		*/
+		void close(uint64_t truncate = 0) {
+#ifdef _WIN32
+			if (ptr != NULL) {
+				if (writable)FlushViewOfFile(ptr, 0);
+				UnmapViewOfFile(ptr);
+			}
+			if (mapping != NULL)CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE) {
+				if (writable && truncate > 0) {
+					LARGE_INTEGER pos;
+					pos.QuadPart = (LONGLONG)truncate;
+					if (SetFilePointerEx(file, pos, NULL, FILE_BEGIN))SetEndOfFile(file);
+				}
+				CloseHandle(file);
+			}
+			mapping = NULL;
+			file = INVALID_HANDLE_VALUE;
+#else
+			if (ptr != NULL) {
+				if (writable)msync(ptr, (size_t)length, MS_SYNC);
+				munmap(ptr, (size_t)length);
+			}
+			if (fd >= 0) {
+				if (writable && truncate > 0 && ftruncate(fd, (off_t)truncate) != 0) {}
+				::close(fd);
+			}
+			fd = -1;
+#endif
+			ptr = NULL;
+			length = 0;
+		}
+
+		/**
+		* 擪̃AhX
+		* @return char* AhX(JĂȂNULL)
+		*/
+		inline char* data() const {
+			return ptr;
+		}
+
+		/**
+		* 傫
+		* @return uint64_t 傫
+		*/
+		inline uint64_t size() const {
+			return length;
+		}
+	};
+
+	/**
+	* L^̓v
+	*/
+	struct recorder_stats {
+		uint64_t frames = 0;		//񂾉摜
+		uint64_t bytes = 0;			//񂾑傫(wb_Ƌlߕ܂)
+		uint64_t dropped = 0;		//ݑ҂t@CtŋL^łȂ摜
+		uint64_t maxQueued = 0;		//ݑ҂̍ő吔
+		uint64_t capacity = 0;		//t@C̑傫
+	};
+
+	/**
+	* ϊ̉摜̋L^
+	* 擾̓obt@ݑ҂̗ɓ邾,pI/OXbh}bvt@C֒ڏ
+	* obt@͏݌releaseŕԂ,rŕȂ
+	*/
+	class raw_recorder {
+	private:
+		struct job {
+			const void* data;
+			raw_record_header header;
+			uint64_t offset;
+			std::function<void()> release;
+		};
+
+		mapped_file file;
+		std::deque<job> jobs;
+		std::mutex mutex;
+		std::condition_variable cond;
+		std::condition_variable drained;
+		std::thread th;
+		bool running = false;
+		size_t pending = 0;				//ݑ҂Əݒ̐(releaseĂԂ܂)
+		size_t maxQueued = 0;
+		uint64_t reserved = 0;			//ݑ҂܂߂̈ʒu
+		recorder_stats stats;
+
+		static inline uint64_t roundUp(uint64_t size, uint64_t unit) {
+			return ((size + unit - 1) / unit) * unit;
+		}
+
+		/**
+		* ݃[v
+		*/
+		void loop() {
+			raw_file_header* fileHeader = (raw_file_header*)file.data();
+			while (true) {
+				job j;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					cond.wait(lock, [this] { return !running || !jobs.empty(); });
+					if (jobs.empty())return;
+					j = std::move(jobs.front());
+					jobs.pop_front();
+				}
+
+				char* dst = file.data() + j.offset;
+				memcpy(dst + RAW_RECORD_PAYLOAD_OFFSET, j.data, (size_t)j.header.payloadSize);
+				memcpy(dst, &j.header, sizeof(j.header));
+				if (j.release)j.release();
+
+				fileHeader->frameCount++;
+				fileHeader->dataEnd = j.offset + j.header.recordSize;
+				std::lock_guard<std::mutex> lock(mutex);
+				stats.frames++;
+				stats.bytes += j.header.recordSize;
+				if (--pending == 0)drained.notify_all();
+			}
+		}
+
+	public:
+		raw_recorder() {}
+		raw_recorder(const raw_recorder&) = delete;
+		raw_recorder& operator=(const raw_recorder&) = delete;
+
+		~raw_recorder() {
+			close();
+		}
+
+		/**
+		* L^̊Jn
+		* @param[in] path o͐
+		* @param[in] capacity t@C̑傫(L^ł)
+		* @param[in] queueSize ݑ҂ɂł摜(擾obt@菭Ȃ)
+		* @param[in] serialNumber L^J̃VAio[
+		* @param[in] model L^J̃f
+		* @return bool Jnł
+		*/
+		bool open(const std::string& path, uint64_t capacity, size_t queueSize, const std::string& serialNumber = "", const std::string& model = "") {
+			close();
+			capacity = roundUp(capacity, RAW_FILE_ALIGNMENT);
+			if (capacity <= RAW_FILE_ALIGNMENT || !file.create(path, capacity))return false;
+
+			raw_file_header* fileHeader = (raw_file_header*)file.data();
+			memcpy(fileHeader->magic, RAW_FILE_MAGIC, sizeof(RAW_FILE_MAGIC));
+			fileHeader->version = 1;
+			fileHeader->headerSize = (uint32_t)RAW_FILE_ALIGNMENT;
+			fileHeader->frameCount = 0;
+			fileHeader->dataEnd = RAW_FILE_ALIGNMENT;
+			memset(fileHeader->serialNumber, 0, sizeof(fileHeader->serialNumber));
+			memset(fileHeader->model, 0, sizeof(fileHeader->model));
+			strncpy(fileHeader->serialNumber, serialNumber.c_str(), sizeof(fileHeader->serialNumber) - 1);
+			strncpy(fileHeader->model, model.c_str(), sizeof(fileHeader->model) - 1);
+
+			maxQueued = queueSize < 1 ? 1 : queueSize;
+			reserved = RAW_FILE_ALIGNMENT;
+			stats = recorder_stats();
+			stats.capacity = capacity;
+			running = true;
+			th = std::thread([this] { loop(); });
+			return true;
+		}
+
+		/**
+		* 摜̏ݑ҂ւ̒ǉ
+		* ߂ȂꍇreleaseĂ΂falseԂ,ĂяoŃobt@Ԃ
+		* @param[in] data 摜(݌releaseĂ΂܂ŗLł邱)
+		* @param[in] header R[h̃wb_(payloadSizeݒ肵Ă)
+		* @param[in] release ݌I/OXbhŌĂ΂
+		* @return bool ݑ҂ɂł
+		*/
+		bool push(const void* data, const raw_record_header& header, std::function<void()> release) {
+			job j;
+			j.data = data;
+			j.header = header;
+			j.header.recordSize = roundUp(RAW_RECORD_PAYLOAD_OFFSET + header.payloadSize, RAW_FILE_ALIGNMENT);
+			j.release = std::move(release);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!running || jobs.size() >= maxQueued || reserved + j.header.recordSize > file.size()) {
+					stats.dropped++;
+					return false;
+				}
+				j.offset = reserved;
+				reserved += j.header.recordSize;
+				jobs.push_back(std::move(j));
+				pending++;
+				if (jobs.size() > stats.maxQueued)stats.maxQueued = jobs.size();
+			}
+			cond.notify_one();
+			return true;
+		}
+
+		/**
+		* L^̏I
+		* ݑ҂SďĂ,t@C񂾑傫ɐ؂l߂
+		*/
+		void close() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!running)return;
+				running = false;
+			}
+			cond.notify_all();
+			if (th.joinable())th.join();
+			uint64_t end = ((raw_file_header*)file.data())->dataEnd;
+			file.close(end);
+		}
+
+		/**
+		* ݑ҂Ȃ܂ő҂
+		* (҂Ăobt@͑SreleaseŕԂ)
+		*/
+		void flush() {
+			std::unique_lock<std::mutex> lock(mutex);
+			drained.wait(lock, [this] { return pending == 0; });
+		}
+
+		/**
+		* L^
+		* @return bool L^
+		*/
+		inline bool isOpen() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return running;
+		}
+
+		/**
+		* v̎擾
+		* @return recorder_stats v
+		*/
+		recorder_stats getStats() {
+			std::lock_guard<std::mutex> lock(mutex);
+			return stats;
+		}
+	};
+
+	/**
+	* L^t@C̓ǂݍ
+	* t@CŜ}bvăR[hɂǂ邽,摜Ƃ̊mۂ╡Ȃ
+	*/
+	class raw_reader {
+	private:
+		mapped_file file;
+		uint64_t offset = 0;
+		uint64_t end = 0;
+		uint64_t index = 0;
+
+	public:
+		/**
+		* J
+		* @param[in] path pX
+		* @return bool L^t@CƂĊJ
+		*/
+		bool open(const std::string& path) {
+			if (!file.open(path))return false;
+			const raw_file_header* h = header();
+			if (file.size() < RAW_FILE_ALIGNMENT || memcmp(h->magic, RAW_FILE_MAGIC, sizeof(RAW_FILE_MAGIC)) != 0 || h->version != 1 || h->headerSize > file.size()) {
+				file.close();
+				return false;
+			}
+			end = std::min(h->dataEnd, file.size());
+			rewind();
+			return true;
+		}
+
+		/**
+		* 
+		*/
+		void close() {
+			file.close();
+		}
+
+		/**
+		* JĂ邩
+		* @return bool JĂ邩
+		*/
+		inline bool isOpen() const {
+			return file.data() != NULL;
+		}
+
+		/**
+		* t@C̃wb_
+		* @return const raw_file_header* wb_
+		*/
+		inline const raw_file_header* header() const {
+			return (const raw_file_header*)file.data();
+		}
+
+		/**
+		* ̃R[h
+		* (ꂽR[h΂𖖔Ƃ݂Ȃ)
+		* @return const raw_record_header* R[h(ȂNULL)
+		*/
+		const raw_record_header* next() {
+			if (index >= header()->frameCount || offset + RAW_RECORD_PAYLOAD_OFFSET > end)return NULL;
+			const raw_record_header* r = (const raw_record_header*)(file.data() + offset);
+			if (r->recordSize < RAW_RECORD_PAYLOAD_OFFSET + r->payloadSize || offset + r->recordSize > end)return NULL;
+			offset += r->recordSize;
+			index++;
+			return r;
+		}
+
+		/**
+		* 擪֖߂
+		*/
+		inline void rewind() {
+			offset = header()->headerSize;
+			index = 0;
+		}
+
+		/**
+		* R[h̉摜
+		* @param[in] r R[h
+		* @return const char* 摜̐擪
+		*/
+		static inline const char* payload(const raw_record_header* r) {
+			return (const char*)r + RAW_RECORD_PAYLOAD_OFFSET;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,1566 @@
+#ifndef RSDLAB_BAUMER_SIMULATOR
+#define RSDLAB_BAUMER_SIMULATOR
+
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include "BaumerConvert.h"
+#include "BaumerRecorder.h"
+
+/*
+* \tgEFAŐ摜ԂBGAPI2̑֎
+* RSDLAB_BAUMER_USE_SIMULATOR`Baumer.hǂݍނ,bgapi2_genicam̑ɂ炪g
+* System -> Interface -> Device -> DataStream -> Buffer̊JƎ擾̗SDKƓ
+* L^t@Cw肷,̑ɋL^摜Đ(simulator::setPlayback)
+*/
+
+typedef int64_t bo_int64;
+typedef uint64_t bo_uint64;
+typedef double bo_double;
+typedef bool bo_bool;
+typedef uint32_t bo_uint;
+
+#ifndef BGAPI2CALL
+#define BGAPI2CALL
+#endif
+
+namespace baumer {
+	/**
+	* L^t@C̍Đ̑x
+	*/
+	enum class playback_mode {
+		realtime,		//L^̊ԊuōĐ
+		fast,			//擾̑xōĐ
+		fixed_rate		//AcquisitionFrameRate(simulator_config::fps)ōĐ
+	};
+
+	/**
+	* V~[^̃J1䕪̐ݒ
+	*/
+	struct simulator_config {
+		std::string serialNumber = "SIM0000";		//VAio[
+		std::string model = "SIM-1";				//f
+		std::string firmwareVersion = "1.0.0";		//t@[EFAo[W
+		int width = 1280;							//ZT[̕[pixel]
+		int height = 1024;							//ZT[̍[pixel]
+		double fps = 30;							//t[[g(0ȉȂ҂ɐ)
+		double jitter = 0;							//B̂炬(W΍)[usec]
+		double incompleteRate = 0;					//sSȉ摜ɂȂ銄(0-1)
+		double dropRate = 0;						//]Ɏ銄(0-1, FrameID)
+		std::vector<std::string> pixelFormats;		//IłsNZtH[}bg(Ȃread()S)
+		std::string pixelFormat;					//sNZtH[}bg(Ȃ擪)
+		unsigned int seed = 0;						//̎
+		std::string playbackPath;					//Đt@C(łȂΐ̑ɍĐ)
+		playback_mode playback = playback_mode::realtime;	//Đ̑x
+		bool playbackLoop = true;					//܂ōĐ擪ɖ߂邩
+	};
+
+	namespace simulator {
+		/**
+		* ڑꂽƂɂJ̈ꗗ
+		* SystemList::GetInstancȇOɐݒ肷(ݒ肵Ȃ1)
+		* @return std::vector<simulator_config>& J̈ꗗ
+		*/
+		inline std::vector<simulator_config>& cameras() {
+			static std::vector<simulator_config> list(1);
+			return list;
+		}
+
+		/**
+		* ݒ̃J܂Ƃ߂ēo^
+		* @param[in] count 䐔
+		* @param[in] config ݒ(VAio[ɂ͘AԂt)
+		*/
+		inline void setCameras(int count, const simulator_config& config = simulator_config()) {
+			cameras().clear();
+			for (int i = 0; i < count; i++) {
+				simulator_config c = config;
+				c.serialNumber += std::to_string(i);
+				c.seed = config.seed + i;
+				cameras().push_back(c);
+			}
+		}
+
+		/**
+		* ꂽƂɂJ̃VAio[
+		* @return std::set<std::string>& ꗗ
+		*/
+		inline std::set<std::string>& unplugged() {
+			static std::set<std::string> list;
+			return list;
+		}
+
+		/**
+		* unplugged()̔r
+		* @return std::mutex& ~[ebNX
+		*/
+		inline std::mutex& unpluggedMutex() {
+			static std::mutex m;
+			return m;
+		}
+
+		/**
+		* J̔
+		* ƎDeviceList::RefreshňꗗOĎB~܂,ƐVfoCXƂČ
+		* @param[in] serialNumber VAio[
+		* @param[in] connected ڑ邩
+		*/
+		inline void setConnected(const std::string& serialNumber, bool connected) {
+			std::lock_guard<std::mutex> lock(unpluggedMutex());
+			if (connected) {
+				unplugged().erase(serialNumber);
+			} else {
+				unplugged().insert(serialNumber);
+			}
+		}
+
+		/**
+		* ڑĂ邱ƂɂȂĂ邩
+		* @param[in] serialNumber VAio[
+		* @return bool ڑĂ邩
+		*/
+		inline bool isConnected(const std::string& serialNumber) {
+			std::lock_guard<std::mutex> lock(unpluggedMutex());
+			return unplugged().count(serialNumber) == 0;
+		}
+
+		/**
+		* L^t@CĐJo^
+		* J̑傫ƃsNZtH[}bg͍ŏ̉摜,VAio[ƃf̓t@C猈߂
+		* (t@C̓rŃsNZtH[}bgςĂꍇ,I𒆂̃tH[}bg̉摜Đ)
+		* @param[in] paths t@C̈ꗗ(1t@C1)
+		* @param[in] mode Đ̑x
+		* @param[in] fps playback_mode::fixed_ratẽt[[g
+		* @param[in] loop ܂ōĐ擪ɖ߂邩
+		* @return int o^ł䐔
+		*/
+		inline int setPlayback(const std::vector<std::string>& paths, playback_mode mode = playback_mode::realtime, double fps = 30, bool loop = true) {
+			cameras().clear();
+			for (size_t i = 0; i < paths.size(); i++) {
+				raw_reader reader;
+				if (!reader.open(paths[i]))continue;
+				const raw_record_header* first = reader.next();
+				if (first == NULL)continue;
+
+				simulator_config c;
+				c.serialNumber = reader.header()->serialNumber[0] != 0 ? std::string(reader.header()->serialNumber) : "PLAY";
+				c.model = reader.header()->model[0] != 0 ? std::string(reader.header()->model) : "Playback";
+				for (const auto& other : cameras()) {
+					if (other.serialNumber == c.serialNumber)c.serialNumber += "_" + std::to_string(i);
+				}
+				std::string format(first->pixelFormat, strnlen(first->pixelFormat, sizeof(first->pixelFormat)));
+				c.width = first->width;
+				c.height = first->height;
+				c.pixelFormats.push_back(format);
+				c.pixelFormat = format;
+				c.fps = mode == playback_mode::fixed_rate ? fps : 0;
+				c.playbackPath = paths[i];
+				c.playback = mode;
+				c.playbackLoop = loop;
+				cameras().push_back(c);
+			}
+			return (int)cameras().size();
+		}
+
+		/**
+		* L^t@C̍ő̉摜̑傫
+		* @param[in] path pX
+		* @return bo_uint64 ő̉摜̑傫[byte]
+		*/
+		inline uint64_t maxPayload(const std::string& path) {
+			raw_reader reader;
+			uint64_t size = 0;
+			if (!reader.open(path))return 0;
+			while (const raw_record_header* r = reader.next()) {
+				size = std::max(size, r->payloadSize);
+			}
+			return size;
+		}
+
+		/**
+		* obt@1f̃rbgƗLrbg
+		* @param[in] format sNZtH[}bg
+		* @param[out] depth Lrbg
+		* @param[out] channels `l
+		* @return int 1Tṽrbg(pbNĂȂ816)
+		*/
+		inline int sampleBits(pixel_format format, int& depth, int& channels) {
+			channels = 1;
+			switch (format) {
+			case pixel_format::BGR8: channels = 3; depth = 8; return 8;
+			case pixel_format::BGR10: channels = 3; depth = 10; return 16;
+			case pixel_format::BGR12: channels = 3; depth = 12; return 16;
+			case pixel_format::BGR16: channels = 3; depth = 16; return 16;
+			case pixel_format::Mono8: case pixel_format::BayerRG8: case pixel_format::BayerGB8:
+			case pixel_format::BayerGR8: case pixel_format::BayerBG8:
+				depth = 8; return 8;
+			case pixel_format::Mono10: case pixel_format::BayerRG10: case pixel_format::BayerGB10:
+			case pixel_format::BayerGR10: case pixel_format::BayerBG10:
+				depth = 10; return 16;
+			case pixel_format::Mono12: case pixel_format::BayerRG12: case pixel_format::BayerGB12:
+			case pixel_format::BayerGR12: case pixel_format::BayerBG12:
+				depth = 12; return 16;
+			case pixel_format::Mono16: depth = 16; return 16;
+			case pixel_format::Mono12p: case pixel_format::Mono12Packed: depth = 12; return 12;
+			case pixel_format::Mono10p: depth = 10; return 10;
+			default: depth = 8; return 8;
+			}
+		}
+
+		/**
+		* 1sbyte
+		* @param[in] width 
+		* @param[in] format sNZtH[}bg
+		* @return size_t 1sbyte
+		*/
+		inline size_t rowBytes(int width, pixel_format format) {
+			int depth, channels;
+			int bits = sampleBits(format, depth, channels);
+			return ((size_t)width * channels * bits + 7) / 8;
+		}
+
+		/**
+		* Bayerz2x2̕(0:B, 1:G, 2:R)
+		* @param[in] format sNZtH[}bg
+		* @param[out] cfa ,E,,E̐F
+		* @return bool Bayer
+		*/
+		inline bool bayerLayout(pixel_format format, int cfa[4]) {
+			static const int RG[4] = { 2, 1, 1, 0 };
+			static const int GB[4] = { 1, 0, 2, 1 };
+			static const int GR[4] = { 1, 2, 0, 1 };
+			static const int BG[4] = { 0, 1, 1, 2 };
+			const int* p = NULL;
+			switch (format) {
+			case pixel_format::BayerRG8: case pixel_format::BayerRG10: case pixel_format::BayerRG12: p = RG; break;
+			case pixel_format::BayerGB8: case pixel_format::BayerGB10: case pixel_format::BayerGB12: p = GB; break;
+			case pixel_format::BayerGR8: case pixel_format::BayerGR10: case pixel_format::BayerGR12: p = GR; break;
+			case pixel_format::BayerBG8: case pixel_format::BayerBG10: case pixel_format::BayerBG12: p = BG; break;
+			default: return false;
+			}
+			for (int i = 0; i < 4; i++)cfa[i] = p[i];
+			return true;
+		}
+
+		/**
+		* B
+		*/
+		struct frame_params {
+			int width = 0;
+			int height = 0;
+			int offsetX = 0;
+			int offsetY = 0;
+			int binningH = 1;
+			int binningV = 1;
+			int decimationH = 1;
+			int decimationV = 1;
+			int sensorWidth = 0;
+			int sensorHeight = 0;
+			pixel_format format = pixel_format::Unknown;
+			double exposure = 0;
+			double gain = 0;
+		};
+
+		/**
+		* eXg摜̐
+		* cɎIȊG2Ă,t[ƂɊJns炵ăRs[邾œo
+		* @param[in] p B
+		* @param[out] pattern (2)
+		*/
+		inline void render(const frame_params& p, std::vector<unsigned char>& pattern) {
+			int depth, channels;
+			int bits = sampleBits(p.format, depth, channels);
+			size_t stride = rowBytes(p.width, p.format);
+			pattern.assign(stride * p.height * 2, 0);
+			if (p.width <= 0 || p.height <= 0)return;
+
+			int cfa[4];
+			bool bayer = bayerLayout(p.format, cfa);
+			double maxValue = (double)((1 << depth) - 1);
+			double scale = p.exposure / 10000.0 * std::pow(10.0, p.gain / 20.0);
+			const double pi = 3.14159265358979323846;
+
+			std::vector<unsigned int> samples((size_t)p.width * channels);
+			for (int y = 0; y < p.height; y++) {
+				double band = 0.5 + 0.5 * std::cos(2.0 * pi * 3.0 * y / p.height);
+				for (int x = 0; x < p.width; x++) {
+					//ZT[̈ʒuŊG߂(ROIrjOςĂG̈ꕔɂȂ)
+					double u = (double)(p.offsetX + x) * p.binningH * p.decimationH / p.sensorWidth;
+					double bgr[3] = { (1.0 - u) * 0.8, 0.2 + 0.6 * band, u * 0.8 };
+					if (((x >> 4) + (y >> 4)) & 1) {
+						bgr[0] *= 0.7; bgr[1] *= 0.7; bgr[2] *= 0.7;
+					}
+
+					for (int c = 0; c < channels; c++) {
+						double v;
+						if (channels == 3) {
+							v = bgr[c];
+						} else if (bayer) {
+							v = bgr[cfa[((y & 1) << 1) | (x & 1)]];
+						} else {
+							v = 0.114 * bgr[0] + 0.587 * bgr[1] + 0.299 * bgr[2];
+						}
+						v = std::min(1.0, std::max(0.0, v * scale));
+						samples[(size_t)x * channels + c] = (unsigned int)(v * maxValue + 0.5);
+					}
+				}
+
+				unsigned char* row = &pattern[stride * y];
+				size_t n = samples.size();
+				if (bits == 8) {
+					for (size_t i = 0; i < n; i++)row[i] = (unsigned char)samples[i];
+				} else if (bits == 16) {
+					for (size_t i = 0; i < n; i++) {
+						row[2 * i] = (unsigned char)(samples[i] & 0xFF);
+						row[2 * i + 1] = (unsigned char)(samples[i] >> 8);
+					}
+				} else if (p.format == pixel_format::Mono12Packed) {
+					for (size_t i = 0; i + 1 < n; i += 2) {
+						unsigned char* d = row + i / 2 * 3;
+						d[0] = (unsigned char)(samples[i] >> 4);
+						d[1] = (unsigned char)((samples[i] & 0x0F) | ((samples[i + 1] & 0x0F) << 4));
+						d[2] = (unsigned char)(samples[i + 1] >> 4);
+					}
+				} else {
+					//Mono10p,Mono12p: LSBl߂
+					for (size_t i = 0; i < n; i++) {
+						size_t bit = i * bits;
+						for (int b = 0; b < bits; b++, bit++) {
+							if (samples[i] & (1u << b))row[bit >> 3] |= (unsigned char)(1 << (bit & 7));
+						}
+					}
+				}
+			}
+			memcpy(&pattern[stride * p.height], &pattern[0], stride * p.height);
+		}
+	}
+}
+
+namespace BGAPI2 {
+	class Node;
+	class NodeMap;
+	class Buffer;
+	class BufferList;
+	class DataStream;
+	class Device;
+
+	/**
+	* 
+	*/
+	class String {
+		std::string s;
+	public:
+		String() {}
+		String(const char* c) : s(c == NULL ? "" : c) {}
+		String(const std::string& c) : s(c) {}
+		const char* get() const { return s.c_str(); }
+		operator const char*() const { return s.c_str(); }
+		size_t size() const { return s.size(); }
+		bool operator==(const String& o) const { return s == o.s; }
+		bool operator==(const char* o) const { return s == (o == NULL ? "" : o); }
+		bool operator!=(const String& o) const { return s != o.s; }
+		bool operator!=(const char* o) const { return !(*this == o); }
+		bool operator<(const String& o) const { return s < o.s; }
+		String operator+(const String& o) const { return String(s + o.s); }
+	};
+
+	namespace Exceptions {
+		/**
+		* O̊
+		*/
+		class IException {
+			String sDescription;
+			String sFunction;
+		public:
+			IException(const String& description = "", const String& function = "") : sDescription(description), sFunction(function) {}
+			virtual ~IException() {}
+			String GetErrorDescription() const { return sDescription; }
+			String GetFunctionName() const { return sFunction; }
+			virtual String GetType() const { return "IException"; }
+		};
+
+#define RSDLAB_BAUMER_SIM_EXCEPTION(name) \
+		class name : public IException { \
+		public: \
+			name(const String& description = "", const String& function = "") : IException(description, function) {} \
+			String GetType() const override { return #name; } \
+		};
+
+		RSDLAB_BAUMER_SIM_EXCEPTION(ErrorException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(NotInitializedException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(NotImplementedException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(ResourceInUseException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(AccessDeniedException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(InvalidHandleException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(NoDataException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(InvalidParameterException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(LowLevelException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(AbortException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(InvalidBufferException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(NotAvailableException)
+		RSDLAB_BAUMER_SIM_EXCEPTION(ObjectInvalidException)
+#undef RSDLAB_BAUMER_SIM_EXCEPTION
+	}
+
+	namespace Events {
+		enum EventMode {
+			EVENTMODE_UNREGISTERED,
+			EVENTMODE_POLLING,
+			EVENTMODE_EVENT_HANDLER
+		};
+		typedef void (BGAPI2CALL *NewBufferEventHandler)(void* callBackOwner, Buffer* pBuffer);
+	}
+
+	/**
+	* m[ḧꗗ(O)
+	*/
+	class NodeMap {
+		std::map<String, Node*> nodes;
+	public:
+		typedef std::map<String, Node*>::iterator iterator;
+		~NodeMap();
+		iterator begin() { return nodes.begin(); }
+		iterator end() { return nodes.end(); }
+		bool GetNodePresent(const String& name) { return nodes.find(name) != nodes.end(); }
+		Node* GetNode(const String& name) {
+			auto it = nodes.find(name);
+			if (it == nodes.end())throw Exceptions::NotAvailableException(String("node not found: ") + name, "NodeMap::GetNode");
+			return it->second;
+		}
+		Node* GetNode(bo_uint64 index) {
+			if (index >= nodes.size())throw Exceptions::InvalidParameterException("index out of range", "NodeMap::GetNode");
+			auto it = nodes.begin();
+			std::advance(it, (size_t)index);
+			return it->second;
+		}
+		bo_uint64 GetNodeCount() { return nodes.size(); }
+
+		/**
+		* m[h̒ǉ(L)
+		*/
+		Node* add(Node* node);
+	};
+
+	/**
+	* GenICam̃m[h
+	* l̕ύX͎̃foCX֒ʒm,ˑm[h͈̔͂Bɔf
+	*/
+	class Node {
+		friend class Device;
+		friend class DataStream;
+	public:
+		enum node_type { INTEGER, FLOAT, ENUMERATION, ENUMENTRY, COMMAND, STRING, BOOLEAN };
+
+		Node(const String& name, node_type type, Device* owner = NULL) : sName(name), type(type), pOwner(owner) {}
+		~Node() { delete pEntries; }
+
+		String GetName() { return sName; }
+		String GetInterface() {
+			static const char* names[] = { "IInteger", "IFloat", "IEnumeration", "IEnumEntry", "ICommand", "IString", "IBoolean" };
+			return names[type];
+		}
+		bool IsReadable() { return true; }
+		bool IsWriteable();
+		bool GetAvailable() { return true; }
+		bool IsAvailable() { return true; }
+		bool GetImplemented() { return true; }
+
+		bo_int64 GetInt();
+		void SetInt(bo_int64 value);
+		bo_int64 GetIntMin();
+		bo_int64 GetIntMax();
+		bo_int64 GetIntInc();
+
+		bo_double GetDouble();
+		void SetDouble(bo_double value);
+		bo_double GetDoubleMin();
+		bo_double GetDoubleMax();
+
+		bool GetBool();
+		void SetBool(bool value);
+
+		String GetString();
+		void SetString(const String& value);
+		String GetValue() { return GetString(); }
+		void SetValue(const String& value) { SetString(value); }
+
+		NodeMap* GetEnumNodeList() {
+			if (pEntries == NULL)throw Exceptions::InvalidHandleException(String("not an enumeration: ") + sName, "Node::GetEnumNodeList");
+			return pEntries;
+		}
+
+		void Execute();
+		bool IsDone() { return true; }
+
+	private:
+		String sName;
+		node_type type;
+		Device* pOwner;
+		bool writeable = true;
+		bool locked = false;	//B͕ύXłȂ
+
+		bo_int64 iValue = 0;
+		bo_int64 iMin = 0;
+		bo_int64 iMax = 0;
+		bo_int64 iInc = 1;
+		bo_double fValue = 0;
+		bo_double fMin = 0;
+		bo_double fMax = 0;
+		String sValue;
+		NodeMap* pEntries = NULL;
+		std::function<bo_int64()> getter;	//vlȂǓǂݏoɌ܂l
+
+		void requireType(node_type t, const char* function) {
+			if (type != t)throw Exceptions::InvalidHandleException(String("type mismatch: ") + sName, function);
+		}
+		void requireWriteable(const char* function) {
+			if (!writeable || locked)throw Exceptions::AccessDeniedException(String("node is not writeable: ") + sName, function);
+		}
+	};
+
+	inline NodeMap::~NodeMap() {
+		for (auto& n : nodes)delete n.second;
+	}
+
+	inline Node* NodeMap::add(Node* node) {
+		nodes[node->GetName()] = node;
+		return node;
+	}
+
+	/**
+	* 摜obt@
+	*/
+	class Buffer {
+		friend class BufferList;
+		friend class DataStream;
+	public:
+		Buffer() {}
+		Buffer(void* pUserObj) : pUserObj(pUserObj) {}
+		Buffer(void* pUserBuffer, bo_uint64 size, void* pUserObj) : pMem(pUserBuffer), memSize(size), pUserObj(pUserObj) {}
+		~Buffer() {
+			if (ownsMem)free(pMem);
+		}
+
+		void QueueBuffer();
+		String GetID() { return sID; }
+		void* GetMemPtr() { return pMem; }
+		bo_uint64 GetMemSize() { return memSize; }
+		void* GetUserObj() { return pUserObj; }
+		bo_uint64 GetImageOffset() { return 0; }
+		bo_uint64 GetImageLength() { return sizeFilled; }
+		bo_uint64 GetSizeFilled() { return sizeFilled; }
+		bo_uint64 GetTimestamp() { return timestamp; }
+		bo_uint64 GetFrameID() { return frameID; }
+		bo_uint64 GetWidth() { return width; }
+		bo_uint64 GetHeight() { return height; }
+		bo_uint64 GetXOffset() { return offsetX; }
+		bo_uint64 GetYOffset() { return offsetY; }
+		String GetPixelFormat() { return sPixelFormat; }
+		bool GetIsIncomplete() { return incomplete; }
+		bool GetIsQueued() { return queued; }
+		bool GetNewData() { return !incomplete; }
+
+	private:
+		String sID;
+		void* pMem = NULL;
+		bo_uint64 memSize = 0;
+		bool ownsMem = false;
+		void* pUserObj = NULL;
+		DataStream* pStream = NULL;
+		bool queued = false;
+
+		bool incomplete = false;
+		bo_uint64 sizeFilled = 0;
+		bo_uint64 timestamp = 0;
+		bo_uint64 frameID = 0;
+		bo_uint64 width = 0;
+		bo_uint64 height = 0;
+		bo_uint64 offsetX = 0;
+		bo_uint64 offsetY = 0;
+		String sPixelFormat;
+	};
+
+	/**
+	* f[^Xg[ɓo^obt@̈ꗗ
+	*/
+	class BufferList {
+		friend class DataStream;
+		std::map<String, Buffer*> buffers;
+		DataStream* pStream = NULL;
+		bo_uint64 nextID = 0;
+	public:
+		typedef std::map<String, Buffer*>::iterator iterator;
+		iterator begin() { return buffers.begin(); }
+		iterator end() { return buffers.end(); }
+		bo_uint64 size() { return buffers.size(); }
+
+		void Add(Buffer* buffer);
+		Buffer* RevokeBuffer(Buffer* buffer);
+		void FlushInputToOutputQueue();
+		void FlushAllToInputQueue();
+		void FlushUnqueuedToInputQueue();
+		void DiscardOutputBuffers();
+		void DiscardAllBuffers();
+
+		bo_uint64 GetAnnouncedCount() { return buffers.size(); }
+		bo_uint64 GetQueuedCount();
+		bo_uint64 GetAwaitDelivery();
+		bo_uint64 GetDeliveredCount();
+		bo_uint64 GetUnderrunCount();
+		bo_uint64 GetStartedCount();
+	};
+
+	/**
+	* f[^Xg[
+	* BXbh󂫃obt@ɉ摜,o̓L[Cxgnh֓n
+	*/
+	class DataStream {
+		friend class Buffer;
+		friend class BufferList;
+		friend class Device;
+	public:
+		DataStream(Device* device, const String& id, unsigned int seed);
+		~DataStream() {
+			StopAcquisition();
+		}
+
+		String GetID() { return sID; }
+		void Open() {
+			if (open)throw Exceptions::ResourceInUseException("data stream already open", "DataStream::Open");
+			open = true;
+		}
+		void Close() {
+			StopAcquisition();
+			open = false;
+		}
+		bool IsOpen() { return open; }
+		BufferList* GetBufferList() { return &bufferList; }
+		NodeMap* GetNodeList() { return &nodeList; }
+		Node* GetNode(const String& name) { return nodeList.GetNode(name); }
+		bool GetDefinesPayloadSize() { return true; }
+		bo_uint64 GetPayloadSize();
+		bool GetIsGrabbing() { return running; }
+
+		void StartAcquisitionContinuous() { StartAcquisition(0); }
+		void StartAcquisition(bo_uint64 count);
+		void StopAcquisition();
+		Buffer* GetFilledBuffer(bo_uint64 timeout);
+		void CancelGetFilledBuffer() {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			cancel = true;
+			filled.notify_all();
+		}
+
+		void RegisterNewBufferEvent(Events::EventMode mode = Events::EVENTMODE_EVENT_HANDLER) { eventMode = mode; }
+		void RegisterNewBufferEventHandler(void* owner, Events::NewBufferEventHandler fn) {
+			handlerOwner = owner;
+			handler = fn;
+		}
+		void UnregisterNewBufferEvent() {
+			eventMode = Events::EVENTMODE_POLLING;
+			handler = NULL;
+		}
+		Events::EventMode GetEventMode() { return eventMode; }
+
+	private:
+		Device* pDevice;
+		String sID;
+		unsigned int seed;
+		bool open = false;
+		BufferList bufferList;
+		NodeMap nodeList;
+
+		std::mutex queueMutex;
+		std::condition_variable filled;
+		std::condition_variable freed;
+		std::deque<Buffer*> inputQueue;
+		std::deque<Buffer*> outputQueue;
+		bool cancel = false;
+
+		std::thread producer;
+		std::atomic<bool> running{ false };
+		bo_uint64 remaining = 0;
+		std::atomic<bo_uint64> started{ 0 };
+		std::atomic<bo_uint64> delivered{ 0 };
+		std::atomic<bo_uint64> underrun{ 0 };
+		std::atomic<bo_uint64> lost{ 0 };
+
+		std::atomic<Events::EventMode> eventMode{ Events::EVENTMODE_POLLING };
+		void* handlerOwner = NULL;
+		Events::NewBufferEventHandler handler = NULL;
+
+		baumer::raw_reader player;		//Đ̃t@C(擾~߂Ăʒu͕ۂ)
+
+		void queue(Buffer* buffer) {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			if (buffer->queued)return;
+			buffer->queued = true;
+			inputQueue.push_back(buffer);
+			freed.notify_one();
+		}
+
+		void remove(Buffer* buffer) {
+			std::lock_guard<std::mutex> lock(queueMutex);
+			inputQueue.erase(std::remove(inputQueue.begin(), inputQueue.end(), buffer), inputQueue.end());
+			outputQueue.erase(std::remove(outputQueue.begin(), outputQueue.end(), buffer), outputQueue.end());
+			buffer->queued = false;
+		}
+
+		void run();
+	};
+
+	/**
+	* f[^Xg[̈ꗗ
+	*/
+	class DataStreamList {
+		std::map<String, DataStream*> streams;
+	public:
+		typedef std::map<String, DataStream*>::iterator iterator;
+		~DataStreamList() {
+			for (auto& s : streams)delete s.second;
+		}
+		iterator begin() { return streams.begin(); }
+		iterator end() { return streams.end(); }
+		void Refresh() {}
+		bo_uint64 size() { return streams.size(); }
+		DataStream* operator[](const String& id) {
+			auto it = streams.find(id);
+			return it == streams.end() ? NULL : it->second;
+		}
+		void add(DataStream* stream) { streams[stream->GetID()] = stream; }
+	};
+
+	/**
+	* ͋[J
+	*/
+	class Device {
+		friend class Node;
+		friend class DataStream;
+	public:
+		Device(const baumer::simulator_config& config, const String& id);
+
+		String GetID() { return sID; }
+		String GetModel() { return config.model; }
+		String GetSerialNumber() { return config.serialNumber; }
+		String GetDisplayName() { return String(config.model + " (" + config.serialNumber + ")"); }
+		String GetVendor() { return "Simulator"; }
+		String GetTLType() { return "SIM"; }
+		void Open() {
+			if (open)throw Exceptions::ResourceInUseException("device already open", "Device::Open");
+			open = true;
+		}
+		void Close() {
+			for (auto& s : dataStreams)s.second->StopAcquisition();
+			std::lock_guard<std::mutex> lock(guard);
+			acquiring = false;
+			lockGeometry(false);
+			open = false;
+		}
+		bool IsOpen() { return open; }
+		NodeMap* GetRemoteNodeList() { return &remoteNodes; }
+		Node* GetRemoteNode(const String& name) { return remoteNodes.GetNode(name); }
+		NodeMap* GetNodeList() { return &localNodes; }
+		DataStreamList* GetDataStreams() { return &dataStreams; }
+
+		/**
+		* ꂽ(B~,ȍ~͊JnłȂ)
+		*/
+		void unplug() {
+			std::lock_guard<std::mutex> lock(guard);
+			unplugged = true;
+			acquiring = false;
+			triggers = 0;
+			wake.notify_all();
+		}
+
+	private:
+		baumer::simulator_config config;
+		String sID;
+		bool open = false;
+		NodeMap remoteNodes;
+		NodeMap localNodes;
+
+		std::mutex guard;				//m[h̒lƎB
+		std::condition_variable wake;	//BԂ̕ω
+		bool acquiring = false;
+		bool unplugged = false;
+		bo_uint64 triggers = 0;
+		bo_uint64 version = 0;			//Bς邽тɑ
+		bo_uint64 frameCounter = 0;
+		DataStreamList dataStreams;		//BXbhguardgߍŏɔj
+
+		Node* pWidth;
+		Node* pHeight;
+		Node* pWidthMax;
+		Node* pHeightMax;
+		Node* pOffsetX;
+		Node* pOffsetY;
+		Node* pBinningH;
+		Node* pBinningV;
+		Node* pDecimationH;
+		Node* pDecimationV;
+		Node* pPixelFormat;
+		Node* pPayloadSize;
+		Node* pExposureTime;
+		Node* pGain;
+		Node* pFrameRate;
+		Node* pTriggerMode;
+		Node* pTriggerSelector;
+		Node* pBurstFrameCount;
+		bo_uint64 playbackPayload = 0;	//Đ͋L^摜܂obt@ɂ
+		Node* pTriggerSource;
+
+		Node* addInt(const char* name, bo_int64 value, bo_int64 vmin, bo_int64 vmax, bo_int64 inc = 1, bool writeable = true) {
+			Node* n = remoteNodes.add(new Node(name, Node::INTEGER, this));
+			n->iValue = value; n->iMin = vmin; n->iMax = vmax; n->iInc = inc; n->writeable = writeable;
+			return n;
+		}
+		Node* addFloat(const char* name, bo_double value, bo_double vmin, bo_double vmax) {
+			Node* n = remoteNodes.add(new Node(name, Node::FLOAT, this));
+			n->fValue = value; n->fMin = vmin; n->fMax = vmax;
+			return n;
+		}
+		Node* addEnum(const char* name, const std::vector<std::string>& entries, const std::string& value) {
+			Node* n = remoteNodes.add(new Node(name, Node::ENUMERATION, this));
+			n->pEntries = new NodeMap();
+			for (auto& e : entries) {
+				Node* entry = n->pEntries->add(new Node(e.c_str(), Node::ENUMENTRY));
+				entry->writeable = false;
+				entry->sValue = e.c_str();
+			}
+			n->sValue = value.c_str();
+			return n;
+		}
+		Node* addString(const char* name, const std::string& value) {
+			Node* n = remoteNodes.add(new Node(name, Node::STRING, this));
+			n->sValue = value.c_str();
+			n->writeable = false;
+			return n;
+		}
+		Node* addCommand(const char* name) {
+			return remoteNodes.add(new Node(name, Node::COMMAND, this));
+		}
+
+		/**
+		* 摜̑傫Ɋւm[h͈̔͂ƃyC[hTCY̍XV(guard擾ς݂ŌĂ)
+		*/
+		void updateGeometry() {
+			bo_int64 widthMax = config.width / (pBinningH->iValue * pDecimationH->iValue) / 8 * 8;
+			bo_int64 heightMax = config.height / (pBinningV->iValue * pDecimationV->iValue) / 2 * 2;
+			pWidthMax->iValue = widthMax;
+			pHeightMax->iValue = heightMax;
+
+			pWidth->iValue = std::min(std::max(pWidth->iValue, pWidth->iMin), widthMax);
+			pHeight->iValue = std::min(std::max(pHeight->iValue, pHeight->iMin), heightMax);
+			pOffsetX->iValue = std::min(pOffsetX->iValue, widthMax - pWidth->iValue);
+			pOffsetY->iValue = std::min(pOffsetY->iValue, heightMax - pHeight->iValue);
+
+			pWidth->iMax = widthMax - pOffsetX->iValue;
+			pHeight->iMax = heightMax - pOffsetY->iValue;
+			pOffsetX->iMax = widthMax - pWidth->iValue;
+			pOffsetY->iMax = heightMax - pHeight->iValue;
+
+			baumer::pixel_format format = baumer::toPixelFormat(pPixelFormat->sValue);
+			pPayloadSize->iValue = (bo_int64)std::max((bo_uint64)(baumer::simulator::rowBytes((int)pWidth->iValue, format) * pHeight->iValue), playbackPayload);
+		}
+
+		/**
+		* BɕύXłȂm[ȟŒ(guard擾ς݂ŌĂ)
+		*/
+		void lockGeometry(bool lock) {
+			Node* nodes[] = { pWidth, pHeight, pBinningH, pBinningV, pDecimationH, pDecimationV, pPixelFormat };
+			for (Node* n : nodes)n->locked = lock;
+		}
+
+		/**
+		* \tgEFAgK҂(guard擾ς݂ŌĂ)
+		*/
+		bool softwareTriggered() {
+			return pTriggerMode->sValue == "On" && pTriggerSource->sValue == "Software";
+		}
+
+		/**
+		* m[hύXꂽ(guard擾ς݂ŌĂ)
+		*/
+		void changed(Node*) {
+			updateGeometry();
+			version++;
+			wake.notify_all();
+		}
+
+		/**
+		* R}h̎s(guard擾ς݂ŌĂ)
+		*/
+		void execute(Node* node) {
+			if (node->sName == "AcquisitionStart") {
+				if (unplugged)throw Exceptions::LowLevelException("device removed", "Node::Execute");
+				acquiring = true;
+				lockGeometry(true);
+			} else if (node->sName == "AcquisitionStop" || node->sName == "AcquisitionAbort") {
+				acquiring = false;
+				triggers = 0;
+				lockGeometry(false);
+			} else if (node->sName == "TriggerSoftware") {
+				//gKݒ̓ZN^ԂŋLȗf
+				if (acquiring && softwareTriggered())triggers += pTriggerSelector->sValue == "FrameBurstStart" ? pBurstFrameCount->iValue : 1;
+			}
+			wake.notify_all();
+		}
+
+		/**
+		* ݂̎B(guard擾ς݂ŌĂ)
+		*/
+		baumer::simulator::frame_params snapshot() {
+			baumer::simulator::frame_params p;
+			p.width = (int)pWidth->iValue;
+			p.height = (int)pHeight->iValue;
+			p.offsetX = (int)pOffsetX->iValue;
+			p.offsetY = (int)pOffsetY->iValue;
+			p.binningH = (int)pBinningH->iValue;
+			p.binningV = (int)pBinningV->iValue;
+			p.decimationH = (int)pDecimationH->iValue;
+			p.decimationV = (int)pDecimationV->iValue;
+			p.sensorWidth = config.width;
+			p.sensorHeight = config.height;
+			p.format = baumer::toPixelFormat(pPixelFormat->sValue);
+			p.exposure = pExposureTime->fValue;
+			p.gain = pGain->fValue;
+			return p;
+		}
+	};
+
+	inline Device::Device(const baumer::simulator_config& c, const String& id) : config(c), sID(id) {
+		std::vector<std::string> formats = config.pixelFormats;
+		if (formats.empty()) {
+			for (const auto& entry : baumer::pixelFormatNames)formats.push_back(entry.name);
+		}
+		std::string format = config.pixelFormat.empty() ? formats[0] : config.pixelFormat;
+		config.width = std::max(8, config.width);
+		config.height = std::max(2, config.height);
+		if (!config.playbackPath.empty())playbackPayload = baumer::simulator::maxPayload(config.playbackPath);
+
+		addString("DeviceVendorName", "Simulator");
+		addString("DeviceModelName", config.model);
+		addString("DeviceSerialNumber", config.serialNumber);
+		addString("DeviceFirmwareVersion", config.firmwareVersion);
+		addInt("SensorWidth", config.width, config.width, config.width, 1, false);
+		addInt("SensorHeight", config.height, config.height, config.height, 1, false);
+		pWidthMax = addInt("WidthMax", config.width, 8, config.width, 8, false);
+		pHeightMax = addInt("HeightMax", config.height, 2, config.height, 2, false);
+		pWidth = addInt("Width", config.width, 8, config.width, 8);
+		pHeight = addInt("Height", config.height, 2, config.height, 2);
+		pOffsetX = addInt("OffsetX", 0, 0, 0, 8);
+		pOffsetY = addInt("OffsetY", 0, 0, 0, 2);
+		pBinningH = addInt("BinningHorizontal", 1, 1, 4);
+		pBinningV = addInt("BinningVertical", 1, 1, 4);
+		pDecimationH = addInt("DecimationHorizontal", 1, 1, 8);
+		pDecimationV = addInt("DecimationVertical", 1, 1, 8);
+		pPixelFormat = addEnum("PixelFormat", formats, format);
+		pPayloadSize = addInt("PayloadSize", 0, 0, INT64_MAX, 1, false);
+		pExposureTime = addFloat("ExposureTime", 10000, 10, 1000000);
+		addEnum("GainSelector", { "All" }, "All");
+		pGain = addFloat("Gain", 0, 0, 24);
+		pFrameRate = addFloat("AcquisitionFrameRate", config.fps > 0 ? config.fps : 0, 0, 100000);
+		pTriggerSelector = addEnum("TriggerSelector", { "FrameStart", "FrameBurstStart" }, "FrameStart");
+		pBurstFrameCount = addInt("AcquisitionBurstFrameCount", 1, 1, 255);
+		pTriggerMode = addEnum("TriggerMode", { "Off", "On" }, "Off");
+		pTriggerSource = addEnum("TriggerSource", { "Software", "Line0", "Line1" }, "Software");
+		addEnum("TriggerActivation", { "RisingEdge", "FallingEdge" }, "RisingEdge");
+		addCommand("TriggerSoftware");
+		addCommand("AcquisitionStart");
+		addCommand("AcquisitionStop");
+		addCommand("AcquisitionAbort");
+		updateGeometry();
+
+		dataStreams.add(new DataStream(this, "Stream0", config.seed));
+	}
+
+	inline bool Node::IsWriteable() {
+		if (pOwner == NULL)return writeable;
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return writeable && !locked;
+	}
+
+	inline bo_int64 Node::GetInt() {
+		if (getter)return getter();
+		requireType(INTEGER, "Node::GetInt");
+		if (pOwner == NULL)return iValue;
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return iValue;
+	}
+
+	inline void Node::SetInt(bo_int64 value) {
+		requireType(INTEGER, "Node::SetInt");
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		requireWriteable("Node::SetInt");
+		if (value < iMin || value > iMax || (value - iMin) % iInc != 0) {
+			throw Exceptions::InvalidParameterException(String("value out of range: ") + sName, "Node::SetInt");
+		}
+		iValue = value;
+		pOwner->changed(this);
+	}
+
+	inline bo_int64 Node::GetIntMin() {
+		requireType(INTEGER, "Node::GetIntMin");
+		if (pOwner == NULL)return iMin;
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return iMin;
+	}
+
+	inline bo_int64 Node::GetIntMax() {
+		requireType(INTEGER, "Node::GetIntMax");
+		if (pOwner == NULL)return iMax;
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return iMax;
+	}
+
+	inline bo_int64 Node::GetIntInc() {
+		requireType(INTEGER, "Node::GetIntInc");
+		return iInc;
+	}
+
+	inline bo_double Node::GetDouble() {
+		requireType(FLOAT, "Node::GetDouble");
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return fValue;
+	}
+
+	inline void Node::SetDouble(bo_double value) {
+		requireType(FLOAT, "Node::SetDouble");
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		requireWriteable("Node::SetDouble");
+		if (value < fMin || value > fMax) {
+			throw Exceptions::InvalidParameterException(String("value out of range: ") + sName, "Node::SetDouble");
+		}
+		fValue = value;
+		pOwner->changed(this);
+	}
+
+	inline bo_double Node::GetDoubleMin() {
+		requireType(FLOAT, "Node::GetDoubleMin");
+		return fMin;
+	}
+
+	inline bo_double Node::GetDoubleMax() {
+		requireType(FLOAT, "Node::GetDoubleMax");
+		return fMax;
+	}
+
+	inline bool Node::GetBool() {
+		requireType(BOOLEAN, "Node::GetBool");
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return iValue != 0;
+	}
+
+	inline void Node::SetBool(bool value) {
+		requireType(BOOLEAN, "Node::SetBool");
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		requireWriteable("Node::SetBool");
+		iValue = value ? 1 : 0;
+		pOwner->changed(this);
+	}
+
+	inline String Node::GetString() {
+		switch (type) {
+		case INTEGER: return String(std::to_string(GetInt()));
+		case FLOAT: return String(std::to_string(GetDouble()));
+		case BOOLEAN: return GetBool() ? "true" : "false";
+		case COMMAND: throw Exceptions::InvalidHandleException(String("command has no value: ") + sName, "Node::GetString");
+		default: break;
+		}
+		if (pOwner == NULL)return sValue;
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		return sValue;
+	}
+
+	inline void Node::SetString(const String& value) {
+		switch (type) {
+		case INTEGER: SetInt(std::strtoll(value, NULL, 10)); return;
+		case FLOAT: SetDouble(std::strtod(value, NULL)); return;
+		case BOOLEAN: SetBool(value == "true" || value == "1"); return;
+		case ENUMERATION: break;
+		default: throw Exceptions::AccessDeniedException(String("node is not writeable: ") + sName, "Node::SetString");
+		}
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		requireWriteable("Node::SetString");
+		if (!pEntries->GetNodePresent(value)) {
+			throw Exceptions::InvalidParameterException(String("no such entry: ") + value, "Node::SetString");
+		}
+		sValue = value;
+		pOwner->changed(this);
+	}
+
+	inline void Node::Execute() {
+		requireType(COMMAND, "Node::Execute");
+		std::lock_guard<std::mutex> lock(pOwner->guard);
+		pOwner->execute(this);
+	}
+
+	inline void Buffer::QueueBuffer() {
+		if (pStream == NULL)throw Exceptions::InvalidBufferException("buffer is not announced", "Buffer::QueueBuffer");
+		pStream->queue(this);
+	}
+
+	inline void BufferList::Add(Buffer* buffer) {
+		if (buffer->pStream != NULL)throw Exceptions::ResourceInUseException("buffer already announced", "BufferList::Add");
+		if (buffer->pMem == NULL) {
+			buffer->memSize = pStream->GetPayloadSize();
+			buffer->pMem = malloc((size_t)buffer->memSize);
+			if (buffer->pMem == NULL)throw Exceptions::LowLevelException("out of memory", "BufferList::Add");
+			buffer->ownsMem = true;
+		}
+		buffer->pStream = pStream;
+		buffer->sID = String("Buffer" + std::to_string(nextID++));
+		buffers[buffer->sID] = buffer;
+	}
+
+	inline Buffer* BufferList::RevokeBuffer(Buffer* buffer) {
+		if (pStream->running)throw Exceptions::ResourceInUseException("acquisition is running", "BufferList::RevokeBuffer");
+		auto it = buffers.find(buffer->sID);
+		if (it == buffers.end() || it->second != buffer) {
+			throw Exceptions::InvalidBufferException("buffer is not announced", "BufferList::RevokeBuffer");
+		}
+		pStream->remove(buffer);
+		buffers.erase(it);
+		buffer->pStream = NULL;
+		return buffer;
+	}
+
+	inline void BufferList::FlushInputToOutputQueue() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		for (Buffer* b : pStream->inputQueue)pStream->outputQueue.push_back(b);
+		pStream->inputQueue.clear();
+		pStream->filled.notify_all();
+	}
+
+	inline void BufferList::FlushAllToInputQueue() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		pStream->inputQueue.clear();
+		pStream->outputQueue.clear();
+		for (auto& b : buffers) {
+			b.second->queued = true;
+			pStream->inputQueue.push_back(b.second);
+		}
+	}
+
+	inline void BufferList::FlushUnqueuedToInputQueue() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		for (auto& b : buffers) {
+			if (b.second->queued)continue;
+			b.second->queued = true;
+			pStream->inputQueue.push_back(b.second);
+		}
+	}
+
+	inline void BufferList::DiscardOutputBuffers() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		for (Buffer* b : pStream->outputQueue)b->queued = false;
+		pStream->outputQueue.clear();
+	}
+
+	inline void BufferList::DiscardAllBuffers() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		for (Buffer* b : pStream->inputQueue)b->queued = false;
+		for (Buffer* b : pStream->outputQueue)b->queued = false;
+		pStream->inputQueue.clear();
+		pStream->outputQueue.clear();
+	}
+
+	inline bo_uint64 BufferList::GetQueuedCount() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		return pStream->inputQueue.size();
+	}
+
+	inline bo_uint64 BufferList::GetAwaitDelivery() {
+		std::lock_guard<std::mutex> lock(pStream->queueMutex);
+		return pStream->outputQueue.size();
+	}
+
+	inline bo_uint64 BufferList::GetDeliveredCount() { return pStream->delivered; }
+	inline bo_uint64 BufferList::GetUnderrunCount() { return pStream->underrun; }
+	inline bo_uint64 BufferList::GetStartedCount() { return pStream->started; }
+
+	inline DataStream::DataStream(Device* device, const String& id, unsigned int seed) : pDevice(device), sID(id), seed(seed) {
+		bufferList.pStream = this;
+		struct counter { const char* name; std::function<bo_int64()> getter; };
+		counter counters[] = {
+			{ "NumAnnounced", [this] { return (bo_int64)bufferList.GetAnnouncedCount(); } },
+			{ "NumQueued", [this] { return (bo_int64)bufferList.GetQueuedCount(); } },
+			{ "NumAwaitDelivery", [this] { return (bo_int64)bufferList.GetAwaitDelivery(); } },
+			{ "NumDelivered", [this] { return (bo_int64)delivered.load(); } },
+			{ "NumUnderrun", [this] { return (bo_int64)underrun.load(); } },
+			{ "NumStarted", [this] { return (bo_int64)started.load(); } },
+			{ "StreamLostFrameCount", [this] { return (bo_int64)lost.load(); } }
+		};
+		for (auto& c : counters) {
+			Node* n = nodeList.add(new Node(c.name, Node::INTEGER));
+			n->writeable = false;
+			n->getter = c.getter;
+		}
+	}
+
+	inline bo_uint64 DataStream::GetPayloadSize() {
+		std::lock_guard<std::mutex> lock(pDevice->guard);
+		return (bo_uint64)pDevice->pPayloadSize->iValue;
+	}
+
+	inline void DataStream::StartAcquisition(bo_uint64 count) {
+		if (!open)throw Exceptions::NotInitializedException("data stream is not open", "DataStream::StartAcquisition");
+		if (running)throw Exceptions::ResourceInUseException("acquisition is running", "DataStream::StartAcquisition");
+		remaining = count;
+		cancel = false;
+		running = true;
+		producer = std::thread([this] { run(); });
+	}
+
+	inline void DataStream::StopAcquisition() {
+		{
+			std::lock_guard<std::mutex> lock(pDevice->guard);
+			running = false;
+			pDevice->wake.notify_all();
+		}
+		if (producer.joinable())producer.join();
+		CancelGetFilledBuffer();
+	}
+
+	inline Buffer* DataStream::GetFilledBuffer(bo_uint64 timeout) {
+		std::unique_lock<std::mutex> lock(queueMutex);
+		cancel = false;
+		if (!filled.wait_for(lock, std::chrono::milliseconds(timeout), [&] { return !outputQueue.empty() || cancel; }) || outputQueue.empty()) {
+			return NULL;
+		}
+		Buffer* buffer = outputQueue.front();
+		outputQueue.pop_front();
+		buffer->queued = false;
+		return buffer;
+	}
+
+	/**
+	* BXbh
+	* t[[gɍ킹(\tgEFAgKȂgKƂ)󂫃obt@։摜
+	*/
+	inline void DataStream::run() {
+		std::mt19937 rng(seed);
+		std::normal_distribution<double> jitter(0.0, 1.0);
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+		std::vector<unsigned char> pattern;
+		baumer::simulator::frame_params params;
+		bo_uint64 rendered = ~(bo_uint64)0;
+		auto next = std::chrono::steady_clock::now();
+		bool wasAcquiring = false;
+
+		const baumer::simulator_config& config = pDevice->config;
+		bool playing = !config.playbackPath.empty();
+		if (playing && !player.isOpen() && !player.open(config.playbackPath)) {
+			std::unique_lock<std::mutex> lock(pDevice->guard);
+			pDevice->wake.wait(lock, [&] { return !running; });
+			return;
+		}
+		const baumer::raw_record_header* record = NULL;
+		bo_uint64 lastHostTimestamp = 0;
+
+		/*
+		* I𒆂̃sNZtH[}bg̎̉摜(ȂNULL)
+		*/
+		auto nextRecord = [&](const std::string& format) -> const baumer::raw_record_header* {
+			bo_uint64 skipped = 0;
+			while (skipped <= player.header()->frameCount) {
+				const baumer::raw_record_header* r = player.next();
+				if (r == NULL) {
+					if (!config.playbackLoop || player.header()->frameCount == 0)return NULL;
+					player.rewind();
+					lastHostTimestamp = 0;
+					r = player.next();
+					if (r == NULL)return NULL;
+				}
+				if (strncmp(r->pixelFormat, format.c_str(), sizeof(r->pixelFormat)) == 0)return r;
+				skipped++;
+			}
+			return NULL;
+		};
+
+		while (true) {
+			std::chrono::steady_clock::time_point captured;
+			bo_uint64 frameID;
+			bool unlimited = false;
+			{
+				std::unique_lock<std::mutex> lock(pDevice->guard);
+				pDevice->wake.wait(lock, [&] { return !running || (pDevice->acquiring && !pDevice->unplugged && (!pDevice->softwareTriggered() || pDevice->triggers > 0)); });
+				if (!running)break;
+
+				if (playing && record == NULL) {
+					record = nextRecord(pDevice->pPixelFormat->sValue.get());
+					if (record == NULL) {
+						//܂ōĐ̂Œ~܂ő҂
+						pDevice->wake.wait(lock, [&] { return !running; });
+						break;
+					}
+				}
+
+				if (pDevice->softwareTriggered()) {
+					pDevice->triggers--;
+					captured = std::chrono::steady_clock::now();
+					wasAcquiring = false;
+				} else {
+					auto now = std::chrono::steady_clock::now();
+					double fps = pDevice->pFrameRate->fValue;
+					if (playing && config.playback == baumer::playback_mode::fast)fps = 0;
+					unlimited = fps <= 0;
+					if (!wasAcquiring)next = now;
+					if (playing && config.playback == baumer::playback_mode::realtime) {
+						//L^Ƃ̎󂯎ԊuōĐ
+						unlimited = false;
+						if (lastHostTimestamp != 0 && record->hostTimestamp > lastHostTimestamp) {
+							next += std::chrono::nanoseconds((long long)(record->hostTimestamp - lastHostTimestamp));
+						}
+					} else if (fps > 0) {
+						next += std::chrono::nanoseconds((long long)(1e9 / fps));
+					}
+					//xꂽ͋l߂Ɏ̂Ă
+					if (next < now)next = now;
+					captured = next + std::chrono::nanoseconds((long long)(pDevice->config.jitter * 1000.0 * jitter(rng)));
+					wasAcquiring = true;
+					if (pDevice->wake.wait_until(lock, captured, [&] { return !running || !pDevice->acquiring || pDevice->softwareTriggered(); })) {
+						wasAcquiring = false;
+						continue;
+					}
+				}
+
+				if (rendered != pDevice->version) {
+					params = pDevice->snapshot();
+					if (!playing)baumer::simulator::render(params, pattern);
+					rendered = pDevice->version;
+				}
+				frameID = pDevice->frameCounter++;
+			}
+
+			const baumer::raw_record_header* current = record;
+			record = NULL;
+			if (current != NULL) {
+				frameID = current->frameID;
+				lastHostTimestamp = current->hostTimestamp;
+			}
+
+			started++;
+			if (uniform(rng) < pDevice->config.dropRate) {
+				lost++;
+				continue;
+			}
+
+			Buffer* buffer = NULL;
+			{
+				std::unique_lock<std::mutex> lock(queueMutex);
+				//t[[ĝƂ͋󂫃obt@ł܂ő҂(擾̑xŐ)
+				if (unlimited)freed.wait_for(lock, std::chrono::milliseconds(100), [&] { return !inputQueue.empty() || !running; });
+				if (!inputQueue.empty()) {
+					buffer = inputQueue.front();
+					inputQueue.pop_front();
+				}
+			}
+			if (buffer == NULL) {
+				underrun++;
+				continue;
+			}
+
+			if (current != NULL) {
+				//L^摜ƃ^f[^̂܂ܕԂ
+				size_t size = (size_t)current->payloadSize;
+				size_t copy = std::min(size, (size_t)buffer->memSize);
+				memcpy(buffer->pMem, baumer::raw_reader::payload(current), copy);
+				buffer->incomplete = copy < size || (current->flags & baumer::RAW_RECORD_INCOMPLETE) != 0;
+				buffer->sizeFilled = copy;
+				buffer->width = current->width;
+				buffer->height = current->height;
+				buffer->offsetX = current->offsetX;
+				buffer->offsetY = current->offsetY;
+				buffer->frameID = frameID;
+				buffer->timestamp = current->timestamp;
+				buffer->sPixelFormat = std::string(current->pixelFormat, strnlen(current->pixelFormat, sizeof(current->pixelFormat)));
+			} else {
+				size_t stride = baumer::simulator::rowBytes(params.width, params.format);
+				size_t size = stride * params.height;
+				size_t scroll = (size_t)((frameID * 2) % (bo_uint64)std::max(1, params.height));
+				size_t copy = std::min(size, (size_t)buffer->memSize);
+				buffer->incomplete = copy < size;
+				if (uniform(rng) < pDevice->config.incompleteRate) {
+					copy = copy / stride / 2 * stride;
+					buffer->incomplete = true;
+				}
+				memcpy(buffer->pMem, &pattern[stride * scroll], copy);
+
+				buffer->sizeFilled = copy;
+				buffer->width = params.width;
+				buffer->height = params.height;
+				buffer->offsetX = params.offsetX;
+				buffer->offsetY = params.offsetY;
+				buffer->frameID = frameID;
+				buffer->timestamp = (bo_uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(captured.time_since_epoch()).count();
+				buffer->sPixelFormat = baumer::toPixelFormatName(params.format);
+			}
+			delivered++;
+
+			if (eventMode == Events::EVENTMODE_EVENT_HANDLER && handler != NULL) {
+				{
+					std::lock_guard<std::mutex> lock(queueMutex);
+					buffer->queued = false;
+				}
+				handler(handlerOwner, buffer);
+			} else {
+				std::lock_guard<std::mutex> lock(queueMutex);
+				outputQueue.push_back(buffer);
+				filled.notify_one();
+			}
+
+			if (remaining > 0 && --remaining == 0)break;
+		}
+	}
+
+	/**
+	* foCẌꗗ
+	*/
+	class DeviceList {
+		std::map<String, Device*> devices;
+		std::vector<Device*> removed;	//ꂽfoCX(J܂܂̃nĥߔj܂Ŏc)
+	public:
+		typedef std::map<String, Device*>::iterator iterator;
+		~DeviceList() {
+			for (auto& d : devices)delete d.second;
+			for (Device* d : removed)delete d;
+		}
+		iterator begin() { return devices.begin(); }
+		iterator end() { return devices.end(); }
+		iterator find(const String& id) { return devices.find(id); }
+		bo_uint64 size() { return devices.size(); }
+		Device* operator[](const String& id) {
+			auto it = devices.find(id);
+			return it == devices.end() ? NULL : it->second;
+		}
+
+		/**
+		* ݒ肳ꂽĴ,܂ĂȂ̂ǉ,ꂽ̂O
+		*/
+		void Refresh(bo_uint64) {
+			for (auto it = devices.begin(); it != devices.end();) {
+				if (baumer::simulator::isConnected(it->second->GetSerialNumber().get())) {
+					it++;
+					continue;
+				}
+				it->second->unplug();
+				removed.push_back(it->second);
+				it = devices.erase(it);
+			}
+			for (auto& config : baumer::simulator::cameras()) {
+				String id = String("SIM_" + config.serialNumber);
+				if (devices.find(id) != devices.end() || !baumer::simulator::isConnected(config.serialNumber))continue;
+				devices[id] = new Device(config, id);
+			}
+		}
+	};
+
+	/**
+	* C^[tF[X
+	*/
+	class Interface {
+		String sID;
+		bool open = false;
+		DeviceList deviceList;
+	public:
+		Interface(const String& id) : sID(id) {}
+		String GetID() { return sID; }
+		String GetDisplayName() { return "Simulated Interface"; }
+		String GetTLType() { return "SIM"; }
+		void Open() { open = true; }
+		void Close() { open = false; }
+		bool IsOpen() { return open; }
+		DeviceList* GetDevices() { return &deviceList; }
+	};
+
+	/**
+	* C^[tF[Ẍꗗ
+	*/
+	class InterfaceList {
+		std::map<String, Interface*> interfaces;
+	public:
+		typedef std::map<String, Interface*>::iterator iterator;
+		~InterfaceList() {
+			for (auto& i : interfaces)delete i.second;
+		}
+		iterator begin() { return interfaces.begin(); }
+		iterator end() { return interfaces.end(); }
+		bo_uint64 size() { return interfaces.size(); }
+		void Refresh(bo_uint64) {
+			if (interfaces.empty())interfaces["SIM_Interface0"] = new Interface("SIM_Interface0");
+		}
+	};
+
+	/**
+	* VXe(Producer)
+	*/
+	class System {
+		String sID;
+		bool open = false;
+		InterfaceList interfaceList;
+	public:
+		System(const String& id) : sID(id) {}
+		String GetID() { return sID; }
+		String GetFileName() { return "simulator"; }
+		String GetTLType() { return "SIM"; }
+		void Open() { open = true; }
+		void Close() { open = false; }
+		bool IsOpen() { return open; }
+		InterfaceList* GetInterfaces() { return &interfaceList; }
+	};
+
+	/**
+	* VXëꗗ(VOg)
+	*/
+	class SystemList {
+		std::map<String, System*> systems;
+		static SystemList*& instance() {
+			static SystemList* p = NULL;
+			return p;
+		}
+	public:
+		typedef std::map<String, System*>::iterator iterator;
+		~SystemList() {
+			for (auto& s : systems)delete s.second;
+		}
+		iterator begin() { return systems.begin(); }
+		iterator end() { return systems.end(); }
+		bo_uint64 size() { return systems.size(); }
+		void Refresh() {
+			if (systems.empty())systems["SIM_System"] = new System("SIM_System");
+		}
+
+		static SystemList* GetInstance() {
+			if (instance() == NULL)instance() = new SystemList();
+			return instance();
+		}
+
+		static void ReleaseInstance() {
+			delete instance();
+			instance() = NULL;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef RSDLAB_BAUMER_STATS
+#define RSDLAB_BAUMER_STATS
+
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace baumer {
+	/**
+	* P鎞v̌ݎ
+	* @return uint64_t [nsec]
+	*/
+	inline uint64_t steadyNow() {
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	* ̋ԂƂ̎Ԍv
+	* ̂Ƃ͎vǂ܂Ȃ
+	*/
+	struct stage_timer {
+		bool enabled;
+		uint64_t last;
+
+		stage_timer(bool enabled) : enabled(enabled), last(enabled ? steadyNow() : 0) {}
+
+		/**
+		* O񂩂̌oߎԂL^
+		* @param[out] elapsed oߎ[nsec]
+		*/
+		template<typename T>
+		inline void lap(T& elapsed) {
+			if (!enabled)return;
+			uint64_t now = steadyNow();
+			elapsed = (T)(now - last);
+			last = now;
+		}
+	};
+
+	/**
+	* Ԃ̃qXgO
+	* 2ׂ̂悲Ƃ16KŐ邽,Œ̃őΌ덷3%x̕ʓ_܂
+	* L^ǂݏõXbh瓯ɍs(ϊv[̊eXbhL^邽,L^͑SăAg~bNɍs)
+	*/
+	struct latency_histogram {
+		static const int SUB_BITS = 4;
+		static const int SUB_COUNT = 1 << SUB_BITS;
+		static const int BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+		std::atomic<uint64_t> counts[BUCKET_COUNT];
+		std::atomic<uint64_t> total{ 0 };
+		std::atomic<uint64_t> sum{ 0 };
+		std::atomic<uint64_t> maxValue{ 0 };
+
+		latency_histogram() {
+			reset();
+		}
+
+		/**
+		* l̋L^
+		* @param[in] value l[nsec]
+		*/
+		inline void record(uint64_t value) {
+			counts[index(value)].fetch_add(1, std::memory_order_relaxed);
+			total.fetch_add(1, std::memory_order_relaxed);
+			sum.fetch_add(value, std::memory_order_relaxed);
+			uint64_t m = maxValue.load(std::memory_order_relaxed);
+			while (value > m && !maxValue.compare_exchange_weak(m, value, std::memory_order_relaxed)) {}
+		}
+
+		/**
+		* SĂ̋L^̔j
+		*/
+		void reset() {
+			for (auto& c : counts)c.store(0, std::memory_order_relaxed);
+			total = 0;
+			sum = 0;
+			maxValue = 0;
+		}
+
+		/**
+		* L^
+		* @return uint64_t L^
+		*/
+		inline uint64_t count() const {
+			return total.load(std::memory_order_relaxed);
+		}
+
+		/**
+		* 
+		* @return double [nsec]
+		*/
+		inline double mean() const {
+			uint64_t n = count();
+			return n == 0 ? 0.0 : (double)sum.load(std::memory_order_relaxed) / n;
+		}
+
+		/**
+		* ől
+		* @return uint64_t ől[nsec]
+		*/
+		inline uint64_t maximum() const {
+			return maxValue.load(std::memory_order_relaxed);
+		}
+
+		/**
+		* ʓ_
+		* @param[in] q (0-1, 0.99Ȃp99)
+		* @return uint64_t ʓ_܂ފK̒l[nsec]
+		*/
+		uint64_t percentile(double q) const {
+			uint64_t n = 0;
+			for (const auto& c : counts)n += c.load(std::memory_order_relaxed);
+			if (n == 0)return 0;
+
+			uint64_t target = (uint64_t)(q * n);
+			if (target >= n)target = n - 1;
+			uint64_t seen = 0;
+			for (int i = 0; i < BUCKET_COUNT; i++) {
+				seen += counts[i].load(std::memory_order_relaxed);
+				if (seen > target)return std::min(middle(i), maximum());
+			}
+			return maximum();
+		}
+
+		/**
+		* l̊K
+		* @param[in] value l
+		* @return int K̔ԍ
+		*/
+		static inline int index(uint64_t value) {
+			if (value < (uint64_t)SUB_COUNT)return (int)value;
+			int shift = highestBit(value) - SUB_BITS;
+			return (shift + 1) * SUB_COUNT + (int)((value >> shift) & (SUB_COUNT - 1));
+		}
+
+		/**
+		* K̉
+		* @param[in] i K̔ԍ
+		* @return uint64_t 
+		*/
+		static inline uint64_t lower(int i) {
+			if (i < SUB_COUNT)return (uint64_t)i;
+			int shift = i / SUB_COUNT - 1;
+			return (uint64_t)(SUB_COUNT + i % SUB_COUNT) << shift;
+		}
+
+		/**
+		* K̒l
+		* @param[in] i K̔ԍ
+		* @return uint64_t l
+		*/
+		static inline uint64_t middle(int i) {
+			if (i < SUB_COUNT)return (uint64_t)i;
+			int shift = i / SUB_COUNT - 1;
+			return lower(i) + (((uint64_t)1 << shift) >> 1);
+		}
+
+		/**
+		* ŏʂ1̃rbgʒu
+		* @param[in] value l(0ȊO)
+		* @return int rbgʒu
+		*/
+		static inline int highestBit(uint64_t value) {
+#ifdef _MSC_VER
+			unsigned long bit;
+			_BitScanReverse64(&bit, value);
+			return (int)bit;
+#else
+			return 63 - __builtin_clzll(value);
+#endif
+		}
+	};
+
+	/**
+	* JƂ̌v
+	* ǂݍ݂̂тɍXV邽,bNg킸ɐnsecōXVł̂
+	*/
+	struct device_counters {
+		std::atomic<uint64_t> delivered{ 0 };	//ǂݍ߂摜
+		std::atomic<uint64_t> incomplete{ 0 };	//sSȉ摜
+		std::atomic<uint64_t> timeouts{ 0 };	//ԓɉ摜Ȃ
+		std::atomic<uint64_t> lost{ 0 };		//FrameIĎԂ琔
+		std::atomic<uint64_t> errors{ 0 };		//OȂǂœǂݍ߂Ȃ
+		latency_histogram convert;				//obt@󂯎肩摜o͂܂ł̎
+		latency_histogram latency;				//obt@󂯎肩Ăяo֓n܂ł̎
+		std::atomic<uint64_t> disconnects{ 0 };	//ꂽ
+		std::atomic<uint64_t> reconnects{ 0 };	//Jēǂݍ݂ĊJ
+		latency_histogram recovery;				//ꂽ̂ɋCtĂǂݍ݂ĊJ܂ł̎
+
+		uint64_t lastFrameID = 0;				//(ǂݍݑ݂̂g)
+		bool hasFrameID = false;
+
+		/**
+		* v̉Z
+		* @param[in,out] counter v
+		* @param[in] n Z
+		*/
+		static inline void add(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+			counter.fetch_add(n, std::memory_order_relaxed);
+		}
+
+		/**
+		* FrameIĎԂ̊mF
+		* @param[in] frameID 󂯎FrameID
+		*/
+		inline void checkFrameID(uint64_t frameID) {
+			if (hasFrameID && frameID > lastFrameID + 1)add(lost, frameID - lastFrameID - 1);
+			lastFrameID = frameID;
+			hasFrameID = true;
+		}
+
+		/**
+		* SĂ̌v̔j
+		*/
+		void reset() {
+			delivered = 0;
+			incomplete = 0;
+			timeouts = 0;
+			lost = 0;
+			errors = 0;
+			convert.reset();
+			latency.reset();
+			disconnects = 0;
+			reconnects = 0;
+			recovery.reset();
+			hasFrameID = false;
+		}
+	};
+
+	/**
+	* Ԃ̕z̗v
+	*/
+	struct latency_summary {
+		uint64_t count = 0;		//L^
+		double mean = 0;		//[nsec]
+		uint64_t p50 = 0;		//l[nsec]
+		uint64_t p99 = 0;		//99p[Z^C[nsec]
+		uint64_t p999 = 0;		//99.9p[Z^C[nsec]
+		uint64_t max = 0;		//ől[nsec]
+
+		latency_summary() {}
+		latency_summary(const latency_histogram& h) : count(h.count()), mean(h.mean()), p50(h.percentile(0.5)), p99(h.percentile(0.99)), p999(h.percentile(0.999)), max(h.maximum()) {}
+	};
+
+	/**
+	* JƂ̓ṽXibvVbg
+	*/
+	struct device_stats {
+		uint64_t delivered = 0;				//ǂݍ߂摜
+		uint64_t incomplete = 0;			//sSȉ摜
+		uint64_t timeouts = 0;				//ԓɉ摜Ȃ
+		uint64_t lost = 0;					//FrameIĎԂ琔
+		uint64_t errors = 0;				//OȂǂœǂݍ߂Ȃ
+		uint64_t driverDelivered = 0;		//hCoo͂摜
+		uint64_t driverUnderrun = 0;		//󂫃obt@̂Ăꂽ摜(hCo)
+		uint64_t driverLost = 0;			//]Ɏꂽ摜(hCo񍐂ꍇ)
+		uint64_t driverQueued = 0;			//hCő󂫃obt@
+		uint64_t driverAwaitDelivery = 0;	//hCȍo̓L[̐[
+		uint64_t grabQueued = 0;			//擾Xbh̃O̐[
+		uint64_t grabDropped = 0;			//擾Xbh̃ÔĂ摜
+		uint64_t connected = 1;				//ڑĂ邩(Ă0)
+		uint64_t disconnects = 0;			//ꂽ
+		uint64_t reconnects = 0;			//Jēǂݍ݂ĊJ
+		latency_summary convert;			//obt@󂯎肩摜o͂܂ł̎
+		latency_summary latency;			//obt@󂯎肩Ăяo֓n܂ł̎
+		latency_summary recovery;			//ꂽ̂ɋCtĂǂݍ݂ĊJ܂ł̎
+	};
+}
+
+#endif